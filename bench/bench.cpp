@@ -0,0 +1,81 @@
+/*
+ * bench.cpp
+ *
+ *  Host CPU time per call, C API against C++ Device interface, with a HAL
+ *  that does no I/O. Absolute numbers are host numbers, compare the ratio.
+ */
+
+#include "calls.h"
+#include "hal_stub.h"
+#include "sd_hal_i2c.h"
+
+#include <chrono>
+#include <cstdio>
+
+I2C_TypeDef i2c1_regs;
+I2C_HandleTypeDef hi2c1 = { &i2c1_regs, { 0, 0 }, 0 };
+
+static const int Iterations = 5000000;
+
+template <class F>
+static double nsPerCall(F f)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Iterations; i++)
+		f();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / Iterations;
+}
+
+/* HAL calls made by one call of f */
+template <class F>
+static uint32_t halCalls(F f)
+{
+	uint32_t before = hal_calls;
+	f();
+	return hal_calls - before;
+}
+
+template <class C, class Cpp>
+static void row(const char* name, C c, Cpp cpp)
+{
+	double nsC = nsPerCall(c);
+	double nsCpp = nsPerCall(cpp);
+	std::printf("%-28s %8.2f %8.2f %8.2f %5u/%u\n", name, nsC, nsCpp, nsC / nsCpp, (unsigned)halCalls(c), (unsigned)halCalls(cpp));
+}
+
+static void header(const char* title)
+{
+	std::printf("%-28s %8s %8s %8s %7s\n", title, "C", "C++", "C/C++", "HAL");
+}
+
+int main()
+{
+	uint8_t buffer[6] = { 0 };
+	uint16_t word;
+
+	header("same transfer, ns/call");
+	row("ReadRegister 1 byte", [&] { c_ReadRegister(buffer, 1); }, [&] { cpp_ReadRegister(buffer, 1); });
+	row("ReadRegister 6 bytes", [&] { c_ReadRegister(buffer, 6); }, [&] { cpp_ReadRegister(buffer, 6); });
+	row("ReadWord", [&] { c_ReadWord(&word); }, [&] { cpp_ReadWord(&word); });
+	row("WriteByte", [&] { c_WriteByte(1); }, [&] { cpp_WriteByte(1); });
+	row("WriteSome", [&] { c_WriteSome(buffer); }, [&] { cpp_WriteSome(buffer); });
+	row("ReadWithNoRegisterAddress", [&] { c_ReadWithNoRegisterAddress(buffer); }, [&] { cpp_ReadWithNoRegisterAddress(buffer); });
+
+	/* C writes the register address, STOPs, then reads; C++ reads with a repeated START */
+	std::printf("\n");
+	header("C STOP vs C++ rep. START");
+	row("ReadByte", [&] { c_ReadByteStop(buffer); }, [&] { cpp_ReadRegister(buffer, 1); });
+	row("ReadBytes 6", [&] { c_ReadBytesStop(buffer, 6); }, [&] { cpp_ReadRegister(buffer, 6); });
+	row("ReadWord", [&] { c_ReadWordStop(&word); }, [&] { cpp_ReadWord(&word); });
+	row("WriteBits", [&] { c_WriteBitsStop(2); }, [&] { cpp_WriteBits(2); });
+
+	/* Same calls again with a timing profile set, so the timing check does a table lookup */
+	SD_I2C_SetDeviceTiming(&hi2c1, 0xD0, 0);
+	std::printf("\n");
+	header("one timing profile set");
+	row("ReadRegister 1 byte", [&] { c_ReadRegister(buffer, 1); }, [&] { cpp_ReadRegister(buffer, 1); });
+	row("ReadRegister 6 bytes", [&] { c_ReadRegister(buffer, 6); }, [&] { cpp_ReadRegister(buffer, 6); });
+
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * calls.h
+ *
+ *  Same set of transfers written once against the C API (calls_c.c)
+ *  and once against the C++ Device interface (calls_cpp.cpp), plus the
+ *  C register reads that put a STOP on the bus the C++ reads do not.
+ */
+
+#ifndef BENCH_CALLS_H_
+#define BENCH_CALLS_H_
+
+#include "stm32f0xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern I2C_HandleTypeDef hi2c1;
+
+/* Same wire transfer through each API, one HAL call each. Register reads use a
+   repeated START (HAL_I2C_Mem_Read) on both sides */
+int c_ReadRegister(uint8_t* data, uint16_t count);
+int c_ReadWord(uint16_t* data);
+int c_WriteByte(uint8_t data);
+int c_WriteSome(uint8_t* data);
+int c_ReadWithNoRegisterAddress(uint8_t* data);
+
+int cpp_ReadRegister(uint8_t* data, uint16_t count);
+int cpp_ReadWord(uint16_t* data);
+int cpp_WriteByte(uint8_t data);
+int cpp_WriteSome(uint8_t* data);
+int cpp_ReadWithNoRegisterAddress(uint8_t* data);
+
+/* C register reads that send a STOP between the register address and the read,
+   two HAL calls each. Compared against the C++ repeated START read, so these rows
+   are different transfers, not the same transfer through two APIs */
+int c_ReadByteStop(uint8_t* data);
+int c_ReadBytesStop(uint8_t* data, uint8_t count);
+int c_ReadWordStop(uint16_t* data);
+int c_WriteBitsStop(uint8_t data);
+
+int cpp_WriteBits(uint8_t data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_CALLS_H_ */
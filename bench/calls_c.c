@@ -0,0 +1,19 @@
+/*
+ * calls_c.c
+ *
+ *  Benchmark transfers through the C API.
+ */
+
+#include "calls.h"
+#include "sd_hal_i2c.h"
+
+int c_ReadRegister(uint8_t* data, uint16_t count) { return SD_I2C_ReadSome(&hi2c1, 0xD0, 0x3B, count, data); }
+int c_ReadWord(uint16_t* data)                    { return SD_I2C_ReadSome(&hi2c1, 0xD0, 0x3B, 2, (uint8_t*)data); }
+int c_WriteByte(uint8_t data)                     { return SD_I2C_WriteByte(&hi2c1, 0x68, 0x6B, data); }
+int c_WriteSome(uint8_t* data)                    { return SD_I2C_WriteSome(&hi2c1, 0xA0, 0x1234, 4, data); }
+int c_ReadWithNoRegisterAddress(uint8_t* data)    { return SD_I2C_ReadWithNoRegisterAddress(&hi2c1, 0x40, data); }
+
+int c_ReadByteStop(uint8_t* data)                 { return SD_I2C_ReadByte(&hi2c1, 0x68, 0x3B, data); }
+int c_ReadBytesStop(uint8_t* data, uint8_t count) { return SD_I2C_ReadBytes(&hi2c1, 0x68, 0x3B, count, data); }
+int c_ReadWordStop(uint16_t* data)                { return SD_I2C_ReadWord(&hi2c1, 0x68, 0x3B, data); }
+int c_WriteBitsStop(uint8_t data)                 { return SD_I2C_WriteBits(&hi2c1, 0x68, 0x1B, 4, 2, data); }
@@ -0,0 +1,20 @@
+/*
+ * calls_cpp.cpp
+ *
+ *  Benchmark transfers through the C++ Device interface.
+ */
+
+#include "calls.h"
+#include "sd_hal_i2c.hpp"
+
+typedef sd_i2c::Bus<&hi2c1> Bus1;
+typedef sd_i2c::Device<Bus1, 0xD0> Mpu6050;     /* SD_I2C_ReadByte(h, 0x68, ...) */
+typedef sd_i2c::Device<Bus1, 0xA0, 2> Eeprom;
+typedef sd_i2c::Device<Bus1, 0x40, 0> Sensor;
+
+int cpp_ReadRegister(uint8_t* data, uint16_t count) { return Mpu6050::readBytes(0x3B, data, count); }
+int cpp_ReadWord(uint16_t* data)                    { return Mpu6050::readWord(0x3B, data); }
+int cpp_WriteByte(uint8_t data)                     { return Mpu6050::writeByte(0x6B, data); }
+int cpp_WriteSome(uint8_t* data)                    { return Eeprom::writeBytes(0x1234, data, 4); }
+int cpp_ReadWithNoRegisterAddress(uint8_t* data)    { return Sensor::readByte(data); }
+int cpp_WriteBits(uint8_t data)                     { return Mpu6050::writeBits(0x1B, 4, 2, data); }
@@ -0,0 +1,117 @@
+/*
+ * hal_stub.c
+ *
+ *  HAL functions that touch no hardware, so benchmarks measure library overhead only.
+ *  An optional speed model (hal_stub.h) adds device SCL limits and bus time.
+ */
+
+#include "hal_stub.h"
+
+volatile uint32_t hal_calls;
+uint64_t hal_bus_clocks;
+uint32_t hal_nacks;
+
+static const hal_device* hal_devices;
+static uint8_t hal_device_count;
+
+void hal_set_devices(const hal_device* devices, uint8_t count)
+{
+	hal_devices = devices;
+	hal_device_count = count;
+}
+
+uint32_t hal_timing_period(uint32_t timing)
+{
+	/* (PRESC + 1) * (SCLL + 1 + SCLH + 1) */
+	return ((timing >> 28) + 1) * ((timing & 0xFF) + ((timing >> 8) & 0xFF) + 2);
+}
+
+/* SCL periods of one frame: START, address byte, data bytes, STOP */
+static uint32_t hal_frame(uint32_t bytes)
+{
+	return 1 + 9 * (1 + bytes) + 1;
+}
+
+/*
+ * Runs one transfer through the speed model
+ * frames: SCL periods the transfer takes when the device ACKs
+ */
+static HAL_StatusTypeDef hal_transfer(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t frames)
+{
+	uint32_t period;
+	uint8_t i;
+
+	hal_calls++;
+	if (hal_device_count == 0)
+		return HAL_OK;
+
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+	/* A disabled peripheral never starts the transfer */
+	if ((hi2c->Instance->CR1 & I2C_CR1_PE) == 0)
+	{
+		hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+		return HAL_TIMEOUT;
+	}
+
+	period = hal_timing_period(hi2c->Instance->TIMINGR);
+	for (i = 0; i < hal_device_count; i++)
+	{
+		if (hal_devices[i].address == (uint8_t)DevAddress && period >= hal_devices[i].min_period)
+		{
+			hal_bus_clocks += (uint64_t)period * frames;
+			return HAL_OK;
+		}
+	}
+
+	/* Address NACKed, bus time of the address byte only */
+	hal_bus_clocks += (uint64_t)period * hal_frame(0);
+	hal_nacks++;
+	hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+	return HAL_ERROR;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef* hi2c)
+{
+	return hi2c->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout)
+{
+	(void)Trials; (void)Timeout;
+	return hal_transfer(hi2c, DevAddress, hal_frame(0));
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)pData; (void)Timeout;
+	return hal_transfer(hi2c, DevAddress, hal_frame(Size));
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+	uint16_t i;
+
+	(void)Timeout;
+	for (i = 0; i < Size; i++)
+		pData[i] = 0;
+	return hal_transfer(hi2c, DevAddress, hal_frame(Size));
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)MemAddress; (void)pData; (void)Timeout;
+	/* MemAddSize is the number of register address bytes */
+	return hal_transfer(hi2c, DevAddress, hal_frame(MemAddSize + Size));
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+	uint16_t i;
+
+	(void)MemAddress; (void)Timeout;
+	for (i = 0; i < Size; i++)
+		pData[i] = 0;
+	/* Register address frame of MemAddSize bytes, then repeated START into the read frame */
+	return hal_transfer(hi2c, DevAddress, hal_frame(MemAddSize) + hal_frame(Size));
+}
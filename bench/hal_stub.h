@@ -0,0 +1,46 @@
+/*
+ * hal_stub.h
+ *
+ *  Controls of the stand-in HAL in hal_stub.c.
+ *
+ *  Without a device table every HAL call succeeds and takes no bus time.
+ *  With one, every transfer checks the SCL period programmed in TIMINGR
+ *  against the device it addresses: a device addressed faster than its
+ *  max SCL, or not in the table, NACKs its address. Transfers add their
+ *  SCL periods to hal_bus_clocks.
+ */
+
+#ifndef BENCH_HAL_STUB_H_
+#define BENCH_HAL_STUB_H_
+
+#include "stm32f0xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint8_t  address;    /* Left aligned device address */
+	uint32_t min_period; /* Shortest SCL period the device follows, in I2C kernel clocks */
+} hal_device;
+
+/* Counts HAL calls, keeps the compiler from dropping them */
+extern volatile uint32_t hal_calls;
+
+/* Simulated bus time in I2C kernel clocks */
+extern uint64_t hal_bus_clocks;
+
+/* Transfers NACKed by the speed model */
+extern uint32_t hal_nacks;
+
+/* Sets devices on the simulated bus, count 0 turns the speed model off */
+void hal_set_devices(const hal_device* devices, uint8_t count);
+
+/* SCL period of a TIMINGR value in I2C kernel clocks, same approximation as sd_hal_i2c.c */
+uint32_t hal_timing_period(uint32_t timing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_HAL_STUB_H_ */
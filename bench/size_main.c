@@ -0,0 +1,32 @@
+/*
+ * size_main.c
+ *
+ *  Links the same-transfer set of benchmark calls, built once per API to compare flash/RAM.
+ */
+
+#include "calls.h"
+
+I2C_TypeDef i2c1_regs;
+I2C_HandleTypeDef hi2c1 = { &i2c1_regs, { 0, 0 }, 0 };
+
+#ifdef BENCH_CPP
+#define CALL(name) cpp_##name
+#else
+#define CALL(name) c_##name
+#endif
+
+int main(void)
+{
+	uint8_t buffer[6] = { 0 };
+	uint16_t word;
+	int r = 0;
+
+	r |= CALL(ReadRegister)(buffer, 1);
+	r |= CALL(ReadRegister)(buffer, 6);
+	r |= CALL(WriteByte)(1);
+	r |= CALL(ReadWord)(&word);
+	r |= CALL(WriteSome)(buffer);
+	r |= CALL(ReadWithNoRegisterAddress)(buffer);
+
+	return r;
+}
@@ -0,0 +1,130 @@
+/*
+ * speed.cpp
+ *
+ *  Simulated bus throughput with and without per-device timing profiles.
+ *  The stub HAL NACKs a device addressed faster than its max SCL and counts
+ *  bus time from TIMINGR, see hal_stub.h. ok/s are successful transfers per
+ *  second of simulated bus time; ns/transfer is host CPU time of library and stub together.
+ */
+
+#include "hal_stub.h"
+#include "sd_hal_i2c.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+I2C_TypeDef i2c1_regs;
+I2C_HandleTypeDef hi2c1 = { &i2c1_regs, { 0, 0 }, 0 };
+
+/* TIMINGR values for 48 MHz I2CCLK from the RM0091 examples */
+static const uint32_t KernelClock = 48000000;
+static const uint32_t Timing100k  = 0xB0420F13;
+static const uint32_t Timing400k  = 0x50330309;
+static const uint32_t Timing1M    = 0x50100103;
+
+typedef sd_i2c::Bus<&hi2c1> Bus1;
+typedef sd_i2c::Device<Bus1, 0xD0> Imu;         /* up to 400 kHz */
+typedef sd_i2c::Device<Bus1, 0xA0, 2> Eeprom;   /* up to 1 MHz */
+typedef sd_i2c::Device<Bus1, 0x40> Sensor;      /* up to 100 kHz */
+
+static hal_device devices[3];
+
+static const int Rounds = 1000000;
+static const int TransfersPerRound = 4;
+
+static uint8_t buffer[32];
+
+/* One main loop pass, devices interleaved */
+static int roundInterleaved()
+{
+	int failed = 0;
+	failed += Imu::readBytes(0x3B, buffer, 14) != SD_I2C_Result_Ok;
+	failed += Sensor::readBytes(0xE3, buffer, 2) != SD_I2C_Result_Ok;
+	failed += Imu::readBytes(0x3B, buffer, 14) != SD_I2C_Result_Ok;
+	failed += Eeprom::readBytes(0x0100, buffer, 32) != SD_I2C_Result_Ok;
+	return failed;
+}
+
+/* Same transfers grouped by device, one timing switch less per pass */
+static int roundGrouped()
+{
+	int failed = 0;
+	failed += Imu::readBytes(0x3B, buffer, 14) != SD_I2C_Result_Ok;
+	failed += Imu::readBytes(0x3B, buffer, 14) != SD_I2C_Result_Ok;
+	failed += Eeprom::readBytes(0x0100, buffer, 32) != SD_I2C_Result_Ok;
+	failed += Sensor::readBytes(0xE3, buffer, 2) != SD_I2C_Result_Ok;
+	return failed;
+}
+
+struct Result {
+	double ns;        /* Host ns per transfer */
+	double switches;  /* Timing switches per pass */
+};
+
+/* Runs Rounds passes and prints a row */
+static Result run(const char* name, int (*round)())
+{
+	uint64_t clocks = hal_bus_clocks;
+	uint32_t switches = SD_I2C_GetTimingSwitches();
+	long failed = 0;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Rounds; i++)
+		failed += round();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	double transfers = (double)Rounds * TransfersPerRound;
+	double seconds = (double)(hal_bus_clocks - clocks) / KernelClock;
+	Result result;
+	result.ns = std::chrono::duration<double, std::nano>(end - start).count() / transfers;
+	result.switches = (double)(SD_I2C_GetTimingSwitches() - switches) / Rounds;
+	std::printf("%-30s %10.0f %8.2f %11.2f %8.2f\n", name, (transfers - failed) / seconds, failed / transfers * 100.0
+			, result.switches, result.ns);
+	return result;
+}
+
+static void setBusTiming(uint32_t timing)
+{
+	hi2c1.Init.Timing = timing;
+	i2c1_regs.TIMINGR = timing;
+	i2c1_regs.CR1 = I2C_CR1_PE;
+}
+
+int main()
+{
+	devices[0].address = 0xD0;
+	devices[0].min_period = hal_timing_period(Timing400k);
+	devices[1].address = 0xA0;
+	devices[1].min_period = hal_timing_period(Timing1M);
+	devices[2].address = 0x40;
+	devices[2].min_period = hal_timing_period(Timing100k);
+	hal_set_devices(devices, 3);
+
+	std::printf("SCL (model): 100k %lu Hz, 400k %lu Hz, 1M %lu Hz\n\n"
+			, (unsigned long)(KernelClock / hal_timing_period(Timing100k))
+			, (unsigned long)(KernelClock / hal_timing_period(Timing400k))
+			, (unsigned long)(KernelClock / hal_timing_period(Timing1M)));
+	std::printf("%-30s %10s %8s %11s %8s\n", "", "ok/s", "failed%", "switch/pass", "ns/xfer");
+
+	/* Without profiles the bus has to run at the slowest device */
+	setBusTiming(Timing1M);
+	run("no profiles, bus 1 MHz", roundInterleaved);
+	setBusTiming(Timing100k);
+	Result none = run("no profiles, bus 100 kHz", roundInterleaved);
+
+	/* Profiles with the bus timing, so every transfer looks up but never switches */
+	SD_I2C_SetDeviceTiming(&hi2c1, 0xD0, Timing100k);
+	SD_I2C_SetDeviceTiming(&hi2c1, 0xA0, Timing100k);
+	Result lookup = run("profiles, all 100 kHz", roundInterleaved);
+
+	/* Every device at its own max, sensor stays at bus timing */
+	SD_I2C_SetDeviceTiming(&hi2c1, 0xD0, Timing400k);
+	SD_I2C_SetDeviceTiming(&hi2c1, 0xA0, Timing1M);
+	Result interleaved = run("profiles, interleaved", roundInterleaved);
+	run("profiles, grouped", roundGrouped);
+
+	std::printf("\nhost cost: lookup %.2f ns/transfer, switch %.2f ns\n", lookup.ns - none.ns
+			, (interleaved.ns - lookup.ns) * TransfersPerRound / interleaved.switches);
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * stm32f0xx_hal.h
+ *
+ *  Host stand-in for the STM32F0 HAL, only what sd_hal_i2c needs.
+ *  Used by the benchmarks in this directory, not for target builds.
+ */
+
+#ifndef BENCH_STM32F0XX_HAL_H_
+#define BENCH_STM32F0XX_HAL_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	HAL_OK      = 0x00,
+	HAL_ERROR   = 0x01,
+	HAL_BUSY    = 0x02,
+	HAL_TIMEOUT = 0x03,
+} HAL_StatusTypeDef;
+
+typedef struct {
+	volatile uint32_t CR1;
+	volatile uint32_t CR2;
+	volatile uint32_t OAR1;
+	volatile uint32_t OAR2;
+	volatile uint32_t TIMINGR;
+} I2C_TypeDef;
+
+typedef struct {
+	uint32_t Timing;
+	uint32_t AddressingMode;
+} I2C_InitTypeDef;
+
+typedef struct {
+	I2C_TypeDef*    Instance;
+	I2C_InitTypeDef Init;
+	uint32_t        ErrorCode;
+} I2C_HandleTypeDef;
+
+#define HAL_I2C_ERROR_NONE       0x00000000U
+#define HAL_I2C_ERROR_BERR       0x00000001U
+#define HAL_I2C_ERROR_ARLO       0x00000002U
+#define HAL_I2C_ERROR_AF         0x00000004U
+#define HAL_I2C_ERROR_OVR        0x00000008U
+#define HAL_I2C_ERROR_DMA        0x00000010U
+#define HAL_I2C_ERROR_TIMEOUT    0x00000020U
+#define HAL_I2C_ERROR_SIZE       0x00000040U
+
+#define I2C_MEMADD_SIZE_8BIT     0x00000001U
+#define I2C_MEMADD_SIZE_16BIT    0x00000002U
+
+#define I2C_CR1_PE               0x00000001U
+#define __HAL_I2C_ENABLE(h)      ((h)->Instance->CR1 |= I2C_CR1_PE)
+#define __HAL_I2C_DISABLE(h)     ((h)->Instance->CR1 &= ~I2C_CR1_PE)
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef* hi2c);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_STM32F0XX_HAL_H_ */
@@ -0,0 +1,5 @@
+/*
+ * stm32f0xx_hal_def.h
+ *
+ *  Host stand-in, everything needed lives in stm32f0xx_hal.h.
+ */
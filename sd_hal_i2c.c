@@ -1,644 +1,1307 @@
-/*
- *  sd_hal_i2c.c
- *
- *  Created on: Mar 5, 2016
- *      Author: Sina Darvishi
- */
-
-#include "sd_hal_i2c.h"
-#include "stm32f0xx_hal_def.h"
-
-/**
- * @brief  This Function check I2Cx peripheral's Error that would be useful
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @retval One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_CheckError(I2C_HandleTypeDef* I2Cx)
-{
-			/* Check error */
-
-			if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_BERR)
-			{
-				return SD_I2C_Result_BERR;
-			}
-			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_ARLO)
-			{
-				return SD_I2C_Result_ARLO;
-			}
-
-			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_AF)
-			{
-				return SD_I2C_Result_AF;
-			}
-
-			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_OVR)
-			{
-				return SD_I2C_Result_OVR;
-			}
-
-			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_DMA)
-			{
-				return SD_I2C_Result_DMA;
-			}
-
-			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_TIMEOUT)
-			{
-				return SD_I2C_Result_TIMEOUT;
-			}
-
-			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_SIZE)
-			{
-				return SD_I2C_Result_SIZE;
-			}
-
-		/* Return error */
-		return SD_I2C_Result_Error;
-
-}
-
-/**
- * @brief  Checks if device is connected to I2C and ready to use
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_IsDeviceConnected(I2C_HandleTypeDef* I2Cx, uint8_t device_address) {
-
-	/* Check if device is ready for communication */
-	if (HAL_I2C_IsDeviceReady(I2Cx, device_address, 2, 5) != HAL_OK)
-	{
-		return SD_I2C_CheckError(I2Cx);
-	}
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/**
- *  write a single bit in an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to write to
- * @param bitNum Bit position to write (0-7)
- * @param value New bit value to write
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_WriteBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address
-		, uint8_t register_address, uint8_t bitNum, uint8_t data)
-{
-
-//	uint8_t b;
-//	if(SD_I2C_Read(I2Cx,device_address,register_address,&b)!= SD_I2C_Result_Ok)
-//	{
-//		return SD_I2C_CheckError(I2Cx);
-//	}
-//
-//	b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
-//
-//	if(SD_I2C_Write(I2Cx,device_address,register_address,b)!= SD_I2C_Result_Ok)
-//	{
-//		return SD_I2C_CheckError(I2Cx);
-//	}
-
-	uint8_t b;
-	SD_I2C_ReadByte(I2Cx,device_address, register_address, &b);
-	b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
-	SD_I2C_WriteByte(I2Cx,device_address, register_address, b);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** write a single bit in a 16-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to write to
- * @param bitNum Bit position to write (0-15)
- * @param value New bit value to write
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_WriteBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t data)
-{
-	 uint16_t w;
-	 SD_I2C_ReadWord(I2Cx,device_address, register_address, &w);
-	 w = (data != 0) ? (w | (1 << bitNum)) : (w & ~(1 << bitNum));
-	 SD_I2C_WriteWord(I2Cx,device_address, register_address, w);
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** Write multiple bits in an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to write to
- * @param bitStart First bit position to write (0-7)
- * @param length Number of bits to write (not more than 8)
- * @param data Right-aligned value to write
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_WriteBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t data)
-{
-	//      010 value to write
-	// 76543210 bit numbers
-	//    xxx   args: bitStart=4, length=3
-	// 00011100 mask byte
-	// 10101111 original value (sample)
-	// 10100011 original & ~mask
-	// 10101011 masked | value
-	uint8_t b;
-	if (SD_I2C_ReadByte(I2Cx,device_address, register_address, &b) != SD_I2C_Result_Ok)
-    {
-		return SD_I2C_CheckError(I2Cx);
-	}
-	else
-	{
-		uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
-		data <<= (bitStart - length + 1); // shift data into correct position
-		data &= mask; // zero all non-important bits in data
-		b &= ~(mask); // zero all important bits in existing byte
-		b |= data; // combine data with existing byte
-		if (SD_I2C_WriteByte(I2Cx,device_address, register_address, b) != SD_I2C_Result_Ok)
-		{
-			return SD_I2C_CheckError(I2Cx);
-		}
-	}
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-/** Write multiple bits in a 16-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to write to
- * @param bitStart First bit position to write (0-15)
- * @param length Number of bits to write (not more than 16)
- * @param data Right-aligned value to write
- * @return One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_WriteBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t data)
-{
-    //              010 value to write
-    // fedcba9876543210 bit numbers
-    //    xxx           args: bitStart=12, length=3
-    // 0001110000000000 mask word
-    // 1010111110010110 original value (sample)
-    // 1010001110010110 original & ~mask
-    // 1010101110010110 masked | value
-    uint16_t w;
-    if (SD_I2C_ReadWord(I2Cx,device_address, register_address, &w) != SD_I2C_Result_Ok)
-    {
-    	return SD_I2C_CheckError(I2Cx);
-    }
-    else
-    {
-        uint16_t mask = ((1 << length) - 1) << (bitStart - length + 1);
-        data <<= (bitStart - length + 1); // shift data into correct position
-        data &= mask; // zero all non-important bits in data
-        w &= ~(mask); // zero all important bits in existing word
-        w |= data; // combine data with existing word
-        SD_I2C_WriteWord(I2Cx,device_address, register_address, w);
-    }
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-/**
- * @brief  Writes single byte to device
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  register_address: Register address where you want to write data
- * @param  data: Data to be written to device
- * @retval Member of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_Write(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data)
-{
-	uint8_t d[2];
-
-	/* Format array to send */
-	d[0] = register_address;
-	d[1] = data;
-
-	/* Try to transmit via I2C */
-	if (HAL_I2C_Master_Transmit(I2Cx, (uint16_t)device_address, (uint8_t *)d, 2, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-/**
- * @brief  Writes multiple data to device
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  register_address: Register address where data will be written
- * @param  *data: Data to be written to device.
- * @param  count: Number of elements to write starting at register register_address
- * @retval One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_WriteSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint16_t count, uint8_t* data)
-{
-
-	/* transmit via I2C */
-	if (HAL_I2C_Mem_Write(I2Cx, device_address, register_address, register_address > 0xFF ? I2C_MEMADD_SIZE_16BIT : I2C_MEMADD_SIZE_8BIT, data, count, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-/** Write single byte from an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to read from
- * @param data Container for byte value read from device
- * @return One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_WriteByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data)
-{
-	SD_I2C_WriteBytes(I2Cx,device_address, register_address, 1, &data);
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** Write multiple bytes to an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_address First register address to write to
- * @param length Number of bytes to write
- * @param data Buffer to copy new data from
- * @return One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_WriteBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address
-		, uint8_t length, uint8_t *data)
-{
-    // Creating dynamic array to store regAddr + data in one buffer
-    uint8_t * dynBuffer;
-    dynBuffer = (uint8_t *) malloc(sizeof(uint8_t) * (length+1));
-    dynBuffer[0] = register_address;
-
-    // copy array
-    memcpy(dynBuffer+1, data, sizeof(uint8_t) * length);
-
-    if( HAL_I2C_Master_Transmit(I2Cx, device_address << 1, dynBuffer, length + 1, 1000)!=HAL_OK)
-    {
-    	return SD_I2C_CheckError(I2Cx);
-    }
-    free(dynBuffer);
-
-	return SD_I2C_Result_Ok;
-}
-/** Write single word to a 16-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register address to write to
- * @param data New word value to write
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_WriteWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t data)
-{
-	SD_I2C_WriteWords(I2Cx,device_address,register_address,1,&data);
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/**
- * @brief  Writes single byte to device without specifying register address, can be used for command write
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  data: Data to be written to device
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_WriteWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t data)
-{
-
-	/* transmit via I2C */
-	if (HAL_I2C_Master_Transmit(I2Cx, (uint16_t)device_address, &data, 1, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-/**
- * @brief  Writes multiple data to device without register address
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  *data: Pointer to data array to be written to device. Array length is the same as number of elements you want to write
- * @param  count: Number of elements to write
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_WriteMultiWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count)
-{
-
-	/* Try to transmit via I2C */
-	if (HAL_I2C_Master_Transmit(I2Cx, (uint16_t)device_address, data, count, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-/**
- * @brief  Writes single byte in a 16-bit length register address
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  register_address: Register address where data will be written
- * @param  data: Data byte to write
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_WriteWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t data)
-{
-	uint8_t d[3];
-
-	/* Format array to send */
-	d[0] = (register_address >> 8) & 0xFF; /* High byte */
-	d[1] = (register_address) & 0xFF;      /* Low byte */
-	d[2] = data;                           /* Data byte */
-
-	/* Try to transmit via I2C */
-	if (HAL_I2C_Master_Transmit(I2Cx, (uint16_t)device_address, (uint8_t *)d, 3, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** Read a single bit from an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_addr Register regAddr to read from
- * @param bitNum Bit position to read (0-7)
- * @param data Container for single bit value
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum, uint8_t *data)
-{
-	uint8_t b;
-	if(SD_I2C_ReadByte(I2Cx,device_address, register_address, &b)!=SD_I2C_Result_Ok)
-	{
-		return SD_I2C_CheckError(I2Cx);
-	}
-	*data = b & (1 << bitNum);
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** Read a single bit from a 16-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to read from
- * @param bitNum Bit position to read (0-15)
- * @param data Container for single bit value
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t *data)
-{
-	uint16_t b;
-	SD_I2C_ReadWord(I2Cx,device_address, register_address, &b);
-	*data = b & (1 << bitNum);
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** Read multiple bits from an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_addr Register regAddr to read from
- * @param bitStart First bit position to read (0-7)
- * @param length Number of bits to read (not more than 8)
- * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t *data)
-{
-	// 01101001 read byte
-	// 76543210 bit numbers
-	//    xxx   args: bitStart=4, length=3
-	//    010   masked
-	//   -> 010 shifted
-	uint8_t b;
-	if(SD_I2C_ReadByte(I2Cx,device_address,register_address,&b)!= SD_I2C_Result_Ok)
-	{
-		return SD_I2C_Result_Error;
-	}
-
-		uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
-		b &= mask;
-		b >>= (bitStart - length + 1);
-		*data = b;
-
-		/* Return OK */
-		return SD_I2C_Result_Ok;
-}
-/** Read multiple bits from a 16-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to read from
- * @param bitStart First bit position to read (0-15)
- * @param length Number of bits to read (not more than 16)
- * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t *data)
-{
-    // 1101011001101001 read byte
-    // fedcba9876543210 bit numbers
-    //    xxx           args: bitStart=12, length=3
-    //    010           masked
-    //           -> 010 shifted
-    uint16_t w;
-    if (SD_I2C_ReadWord(I2Cx,device_address, register_address, &w) != SD_I2C_Result_Ok)
-    {
-    	return SD_I2C_CheckError(I2Cx);
-    }
-    else
-    {
-        uint16_t mask = ((1 << length) - 1) << (bitStart - length + 1);
-        w &= mask;
-        w >>= (bitStart - length + 1);
-        *data = w;
-    }
-	return SD_I2C_Result_Ok;
-}
-/**
- * @brief  Reads single byte from device
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  register_address: Register address from where read will be done
- * @param  *data: Pointer to variable where data will be stored from read operation
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_Read(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t* data)
-{
-
-	/* Send address */
-	if (HAL_I2C_Master_Transmit(I2Cx, (uint16_t)device_address, &register_address, 1, 1000) != HAL_OK)
-	{
-		return SD_I2C_CheckError(I2Cx);
-	}
-
-	/* Receive multiple byte */
-	if (HAL_I2C_Master_Receive(I2Cx, (uint16_t)device_address, data, 1, 1000) != HAL_OK)
-	{
-		return SD_I2C_CheckError(I2Cx);
-	}
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-/**
- * @brief  Reads multiple bytes from device
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  register_address: Register address from where read operation will start
- * @param  *data: Pointer to variable where data will be stored from read operation
- * @param  count: Number of elements to read from device
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_ReadSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address
-		, uint8_t register_address, uint16_t count, uint8_t* data)
-{
-	if (HAL_I2C_Mem_Read(I2Cx, (uint16_t)device_address
-			, register_address,register_address > 0xFF ? I2C_MEMADD_SIZE_16BIT : I2C_MEMADD_SIZE_8BIT
-					,data, count, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** Read single byte from an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_address Register regAddr to read from
- * @param data Container for byte value read from device
- * @return One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_ReadByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t *data)
-{
-	SD_I2C_ReadBytes(I2Cx,device_address, register_address, 1, data);
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-
-
-
-/** Read multiple bytes from an 8-bit device register.
- * @param device_address I2C slave device address
- * @param register_address First register regAddr to read from
- * @param count Number of bytes to read
- * @param data Buffer to store read data in
- * @return One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_ReadBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address
-		, uint8_t register_address, uint8_t count, uint8_t *data)
-{
-		if(HAL_I2C_Master_Transmit(I2Cx, device_address << 1, &register_address, 1 , 1000) != HAL_OK )
-		{
-			return SD_I2C_CheckError(I2Cx);
-		}
-		if (HAL_I2C_Master_Receive(I2Cx, device_address << 1, data, count , 1000 ) != HAL_OK)
-		{
-			return SD_I2C_CheckError(I2Cx);
-		}
-
-	return SD_I2C_Result_Ok;
-}
-/** Write single word to a 16-bit device register.
- * @param devAddr I2C slave device address
- * @param regAddr Register address to write to
- * @param data New word value to write
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t *data)
-{
-	SD_I2C_ReadWords(I2Cx,device_address,register_address,1,data);
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/** Read multiple words from a 16-bit device register.
- * @param device_address I2C slave device address
- * @param register_address First register regAddr to read from
- * @param length Number of words to read
- * @param data Buffer to store read data in
- * @return One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadWords(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address
-		, uint8_t length,uint16_t *data)
-{
-//	uint8_t count;
-//	uint8_t AWord[2];
-//
-//	for (count = 0; count < length; count++) {
-//		SD_I2C_ReadSome(I2Cx,device_address,register_address,1,&AWord[0]);
-//		SD_I2C_ReadSome(I2Cx,device_address,register_address,1,&AWord[1]);
-//
-//		uint16_t DataBits = (( AWord[0]<<8 )| AWord[1] );
-//		*data++ = DataBits;
-//		}
-//	/* Return OK */
-	if(HAL_I2C_Master_Transmit(I2Cx, device_address << 1, &register_address, 1 , 1000)!=HAL_OK)
-	{
-		return SD_I2C_CheckError(I2Cx);
-	}
-	if (HAL_I2C_Master_Receive(I2Cx, device_address << 1, (uint8_t *)data, length*2 , 1000) != HAL_OK)
-	{
-		return SD_I2C_CheckError(I2Cx);
-	}
-	return SD_I2C_Result_Ok;
-}
-/**
- * @brief  Reads I2C data without specifying register address
- * @note   This can be used if your sensors just sends data, without any registers
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  *data: Pointer to variable where data will be stored from read operation
- * @retval One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data)
-{
-
-	/* Receive single byte without specifying  */
-	if (HAL_I2C_Master_Receive(I2Cx, (uint16_t)device_address, data, 1, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/**
- * @brief  Reads multiple bytes from device without specifying register address
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  *data: Pointer to variable where data will be stored from read operation
- * @param  count: Number of elements to read from device
- * @retval One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadSomeWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count)
-{
-
-	/* Receive multi bytes without specifying  */
-	if (HAL_I2C_Master_Receive(I2Cx, (uint16_t)device_address, data, count, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
-/**
- * @brief  Reads single byte from device with 16-bit register address
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @param  register_address: Register address from where read will be done
- * @param  *data: Pointer to variable where data will be stored from read operation
- * @retval One of @ref SD_I2C_Result enumeration
- */
-SD_I2C_Result SD_I2C_ReadWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t* data) {
-	uint8_t adr[2];
-
-	/* Format I2C address */
-	adr[0] = (register_address >> 8) & 0xFF; /* High byte */
-	adr[1] = (register_address) & 0xFF;      /* Low byte */
-
-	/* Send address */
-	if (HAL_I2C_Master_Transmit(I2Cx, (uint16_t)device_address, adr, 2, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-	/* Receive multiple byte */
-	if (HAL_I2C_Master_Receive(I2Cx, device_address, data, 1, 1000) != HAL_OK)
-		return SD_I2C_CheckError(I2Cx);
-
-
-	/* Return OK */
-	return SD_I2C_Result_Ok;
-}
+/*
+ *  sd_hal_i2c.c
+ *
+ *  Created on: Mar 5, 2016
+ *      Author: Sina Darvishi
+ */
+
+#include "sd_hal_i2c.h"
+#include "stm32f0xx_hal_def.h"
+
+static void SD_I2C_SetBusTiming(I2C_HandleTypeDef* I2Cx, uint32_t timing);
+static uint32_t SD_I2C_GroupTiming(I2C_HandleTypeDef* I2Cx, const SD_I2C_Group* group);
+
+/**
+ * @brief  This Function check I2Cx peripheral's Error that would be useful
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_CheckError(I2C_HandleTypeDef* I2Cx)
+{
+			/* Check error */
+
+			if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_BERR)
+			{
+				return SD_I2C_Result_BERR;
+			}
+			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_ARLO)
+			{
+				return SD_I2C_Result_ARLO;
+			}
+
+			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_AF)
+			{
+				return SD_I2C_Result_AF;
+			}
+
+			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_OVR)
+			{
+				return SD_I2C_Result_OVR;
+			}
+
+			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_DMA)
+			{
+				return SD_I2C_Result_DMA;
+			}
+
+			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_TIMEOUT)
+			{
+				return SD_I2C_Result_TIMEOUT;
+			}
+
+			else if (HAL_I2C_GetError(I2Cx) == HAL_I2C_ERROR_SIZE)
+			{
+				return SD_I2C_Result_SIZE;
+			}
+
+		/* Return error */
+		return SD_I2C_Result_Error;
+
+}
+
+/**
+ * @brief  Transmits data to device
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  address: Left aligned device address, as passed to HAL
+ * @param  *data: Data to be written to device
+ * @param  count: Number of bytes to write
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+static SD_I2C_Result SD_I2C_Transmit(I2C_HandleTypeDef* I2Cx, uint16_t address, uint8_t* data, uint16_t count)
+{
+	SD_I2C_ApplyTiming(I2Cx, (uint8_t)address);
+
+	if (HAL_I2C_Master_Transmit(I2Cx, address, data, count, 1000) != HAL_OK)
+		return SD_I2C_CheckError(I2Cx);
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Receives data from device
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  address: Left aligned device address, as passed to HAL
+ * @param  *data: Pointer to buffer where data will be stored
+ * @param  count: Number of bytes to read
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+static SD_I2C_Result SD_I2C_Receive(I2C_HandleTypeDef* I2Cx, uint16_t address, uint8_t* data, uint16_t count)
+{
+	SD_I2C_ApplyTiming(I2Cx, (uint8_t)address);
+
+	if (HAL_I2C_Master_Receive(I2Cx, address, data, count, 1000) != HAL_OK)
+		return SD_I2C_CheckError(I2Cx);
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Transmits register address, then receives data in a separate transfer
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  address: Left aligned device address, as passed to HAL
+ * @param  *tx: Register address bytes to transmit
+ * @param  tx_count: Number of register address bytes
+ * @param  *rx: Pointer to buffer where data will be stored
+ * @param  rx_count: Number of bytes to read
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+static SD_I2C_Result SD_I2C_TransmitReceive(I2C_HandleTypeDef* I2Cx, uint16_t address, uint8_t* tx, uint16_t tx_count
+		, uint8_t* rx, uint16_t rx_count)
+{
+	SD_I2C_Result result = SD_I2C_Transmit(I2Cx, address, tx, tx_count);
+
+	if (result != SD_I2C_Result_Ok)
+		return result;
+
+	return SD_I2C_Receive(I2Cx, address, rx, rx_count);
+}
+
+/**
+ * @brief  Writes data to device registers
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  address: Left aligned device address, as passed to HAL
+ * @param  register_address: Register address where data will be written
+ * @param  size: I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT
+ * @param  *data: Data to be written to device
+ * @param  count: Number of bytes to write
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+static SD_I2C_Result SD_I2C_MemWrite(I2C_HandleTypeDef* I2Cx, uint16_t address, uint16_t register_address, uint16_t size
+		, uint8_t* data, uint16_t count)
+{
+	SD_I2C_ApplyTiming(I2Cx, (uint8_t)address);
+
+	if (HAL_I2C_Mem_Write(I2Cx, address, register_address, size, data, count, 1000) != HAL_OK)
+		return SD_I2C_CheckError(I2Cx);
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Reads data from device registers
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  address: Left aligned device address, as passed to HAL
+ * @param  register_address: Register address from where read will start
+ * @param  size: I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT
+ * @param  *data: Pointer to buffer where data will be stored
+ * @param  count: Number of bytes to read
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+static SD_I2C_Result SD_I2C_MemRead(I2C_HandleTypeDef* I2Cx, uint16_t address, uint16_t register_address, uint16_t size
+		, uint8_t* data, uint16_t count)
+{
+	SD_I2C_ApplyTiming(I2Cx, (uint8_t)address);
+
+	if (HAL_I2C_Mem_Read(I2Cx, address, register_address, size, data, count, 1000) != HAL_OK)
+		return SD_I2C_CheckError(I2Cx);
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Checks if device is connected to I2C and ready to use
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_IsDeviceConnected(I2C_HandleTypeDef* I2Cx, uint8_t device_address) {
+
+	SD_I2C_ApplyTiming(I2Cx, device_address);
+
+	/* Check if device is ready for communication */
+	if (HAL_I2C_IsDeviceReady(I2Cx, device_address, 2, 5) != HAL_OK)
+	{
+		return SD_I2C_CheckError(I2Cx);
+	}
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/**
+ *  write a single bit in an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to write to
+ * @param bitNum Bit position to write (0-7)
+ * @param value New bit value to write
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_WriteBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address
+		, uint8_t register_address, uint8_t bitNum, uint8_t data)
+{
+
+//	uint8_t b;
+//	if(SD_I2C_Read(I2Cx,device_address,register_address,&b)!= SD_I2C_Result_Ok)
+//	{
+//		return SD_I2C_CheckError(I2Cx);
+//	}
+//
+//	b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
+//
+//	if(SD_I2C_Write(I2Cx,device_address,register_address,b)!= SD_I2C_Result_Ok)
+//	{
+//		return SD_I2C_CheckError(I2Cx);
+//	}
+
+	uint8_t b;
+	SD_I2C_ReadByte(I2Cx,device_address, register_address, &b);
+	b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
+	SD_I2C_WriteByte(I2Cx,device_address, register_address, b);
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/** write a single bit in a 16-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to write to
+ * @param bitNum Bit position to write (0-15)
+ * @param value New bit value to write
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_WriteBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t data)
+{
+	 uint16_t w;
+	 SD_I2C_ReadWord(I2Cx,device_address, register_address, &w);
+	 w = (data != 0) ? (w | (1 << bitNum)) : (w & ~(1 << bitNum));
+	 SD_I2C_WriteWord(I2Cx,device_address, register_address, w);
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/** Write multiple bits in an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to write to
+ * @param bitStart First bit position to write (0-7)
+ * @param length Number of bits to write (not more than 8)
+ * @param data Right-aligned value to write
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_WriteBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t data)
+{
+	//      010 value to write
+	// 76543210 bit numbers
+	//    xxx   args: bitStart=4, length=3
+	// 00011100 mask byte
+	// 10101111 original value (sample)
+	// 10100011 original & ~mask
+	// 10101011 masked | value
+	uint8_t b;
+	if (SD_I2C_ReadByte(I2Cx,device_address, register_address, &b) != SD_I2C_Result_Ok)
+    {
+		return SD_I2C_CheckError(I2Cx);
+	}
+	else
+	{
+		uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+		data <<= (bitStart - length + 1); // shift data into correct position
+		data &= mask; // zero all non-important bits in data
+		b &= ~(mask); // zero all important bits in existing byte
+		b |= data; // combine data with existing byte
+		if (SD_I2C_WriteByte(I2Cx,device_address, register_address, b) != SD_I2C_Result_Ok)
+		{
+			return SD_I2C_CheckError(I2Cx);
+		}
+	}
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/** Write multiple bits in a 16-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to write to
+ * @param bitStart First bit position to write (0-15)
+ * @param length Number of bits to write (not more than 16)
+ * @param data Right-aligned value to write
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_WriteBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t data)
+{
+    //              010 value to write
+    // fedcba9876543210 bit numbers
+    //    xxx           args: bitStart=12, length=3
+    // 0001110000000000 mask word
+    // 1010111110010110 original value (sample)
+    // 1010001110010110 original & ~mask
+    // 1010101110010110 masked | value
+    uint16_t w;
+    if (SD_I2C_ReadWord(I2Cx,device_address, register_address, &w) != SD_I2C_Result_Ok)
+    {
+    	return SD_I2C_CheckError(I2Cx);
+    }
+    else
+    {
+        uint16_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+        data <<= (bitStart - length + 1); // shift data into correct position
+        data &= mask; // zero all non-important bits in data
+        w &= ~(mask); // zero all important bits in existing word
+        w |= data; // combine data with existing word
+        SD_I2C_WriteWord(I2Cx,device_address, register_address, w);
+    }
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Writes single byte to device
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register address where you want to write data
+ * @param  data: Data to be written to device
+ * @retval Member of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_Write(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data)
+{
+	uint8_t d[2];
+
+	/* Format array to send */
+	d[0] = register_address;
+	d[1] = data;
+
+	/* Try to transmit via I2C */
+	return SD_I2C_Transmit(I2Cx, device_address, d, 2);
+}
+
+/**
+ * @brief  Writes multiple data to device
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register address where data will be written
+ * @param  *data: Data to be written to device.
+ * @param  count: Number of elements to write starting at register register_address
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_WriteSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint16_t count, uint8_t* data)
+{
+	/* transmit via I2C */
+	return SD_I2C_MemWrite(I2Cx, device_address, register_address, register_address > 0xFF ? I2C_MEMADD_SIZE_16BIT : I2C_MEMADD_SIZE_8BIT, data, count);
+}
+
+/** Write single byte from an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to read from
+ * @param data Container for byte value read from device
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_WriteByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data)
+{
+	SD_I2C_WriteBytes(I2Cx,device_address, register_address, 1, &data);
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/** Write multiple bytes to an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address First register address to write to
+ * @param length Number of bytes to write
+ * @param data Buffer to copy new data from
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_WriteBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address
+		, uint8_t length, uint8_t *data)
+{
+    SD_I2C_Result result;
+
+    // Creating dynamic array to store regAddr + data in one buffer
+    uint8_t * dynBuffer;
+    dynBuffer = (uint8_t *) malloc(sizeof(uint8_t) * (length+1));
+    dynBuffer[0] = register_address;
+
+    // copy array
+    memcpy(dynBuffer+1, data, sizeof(uint8_t) * length);
+
+    result = SD_I2C_Transmit(I2Cx, device_address << 1, dynBuffer, length + 1);
+    free(dynBuffer);
+
+	return result;
+}
+/** Write single word to a 16-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register address to write to
+ * @param data New word value to write
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_WriteWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t data)
+{
+	SD_I2C_WriteWords(I2Cx,device_address,register_address,1,&data);
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/**
+ * @brief  Writes single byte to device without specifying register address, can be used for command write
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  data: Data to be written to device
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_WriteWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t data)
+{
+	/* transmit via I2C */
+	return SD_I2C_Transmit(I2Cx, device_address, &data, 1);
+}
+
+/**
+ * @brief  Writes multiple data to device without register address
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  *data: Pointer to data array to be written to device. Array length is the same as number of elements you want to write
+ * @param  count: Number of elements to write
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_WriteMultiWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count)
+{
+	/* Try to transmit via I2C */
+	return SD_I2C_Transmit(I2Cx, device_address, data, count);
+}
+
+/**
+ * @brief  Writes single byte in a 16-bit length register address
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register address where data will be written
+ * @param  data: Data byte to write
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_WriteWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t data)
+{
+	uint8_t d[3];
+
+	/* Format array to send */
+	d[0] = (register_address >> 8) & 0xFF; /* High byte */
+	d[1] = (register_address) & 0xFF;      /* Low byte */
+	d[2] = data;                           /* Data byte */
+
+	/* Try to transmit via I2C */
+	return SD_I2C_Transmit(I2Cx, device_address, d, 3);
+}
+/** Read a single bit from an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_addr Register regAddr to read from
+ * @param bitNum Bit position to read (0-7)
+ * @param data Container for single bit value
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum, uint8_t *data)
+{
+	uint8_t b;
+	if(SD_I2C_ReadByte(I2Cx,device_address, register_address, &b)!=SD_I2C_Result_Ok)
+	{
+		return SD_I2C_CheckError(I2Cx);
+	}
+	*data = b & (1 << bitNum);
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/** Read a single bit from a 16-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to read from
+ * @param bitNum Bit position to read (0-15)
+ * @param data Container for single bit value
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t *data)
+{
+	uint16_t b;
+	SD_I2C_ReadWord(I2Cx,device_address, register_address, &b);
+	*data = b & (1 << bitNum);
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/** Read multiple bits from an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_addr Register regAddr to read from
+ * @param bitStart First bit position to read (0-7)
+ * @param length Number of bits to read (not more than 8)
+ * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t *data)
+{
+	// 01101001 read byte
+	// 76543210 bit numbers
+	//    xxx   args: bitStart=4, length=3
+	//    010   masked
+	//   -> 010 shifted
+	uint8_t b;
+	if(SD_I2C_ReadByte(I2Cx,device_address,register_address,&b)!= SD_I2C_Result_Ok)
+	{
+		return SD_I2C_Result_Error;
+	}
+
+		uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+		b &= mask;
+		b >>= (bitStart - length + 1);
+		*data = b;
+
+		/* Return OK */
+		return SD_I2C_Result_Ok;
+}
+/** Read multiple bits from a 16-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to read from
+ * @param bitStart First bit position to read (0-15)
+ * @param length Number of bits to read (not more than 16)
+ * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t *data)
+{
+    // 1101011001101001 read byte
+    // fedcba9876543210 bit numbers
+    //    xxx           args: bitStart=12, length=3
+    //    010           masked
+    //           -> 010 shifted
+    uint16_t w;
+    if (SD_I2C_ReadWord(I2Cx,device_address, register_address, &w) != SD_I2C_Result_Ok)
+    {
+    	return SD_I2C_CheckError(I2Cx);
+    }
+    else
+    {
+        uint16_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+        w &= mask;
+        w >>= (bitStart - length + 1);
+        *data = w;
+    }
+	return SD_I2C_Result_Ok;
+}
+/**
+ * @brief  Reads single byte from device
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register address from where read will be done
+ * @param  *data: Pointer to variable where data will be stored from read operation
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_Read(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t* data)
+{
+	/* Send address, then receive byte */
+	return SD_I2C_TransmitReceive(I2Cx, device_address, &register_address, 1, data, 1);
+}
+
+/**
+ * @brief  Reads multiple bytes from device
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register address from where read operation will start
+ * @param  *data: Pointer to variable where data will be stored from read operation
+ * @param  count: Number of elements to read from device
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_ReadSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address
+		, uint8_t register_address, uint16_t count, uint8_t* data)
+{
+	return SD_I2C_MemRead(I2Cx, device_address, register_address, register_address > 0xFF ? I2C_MEMADD_SIZE_16BIT : I2C_MEMADD_SIZE_8BIT, data, count);
+}
+/** Read single byte from an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address Register regAddr to read from
+ * @param data Container for byte value read from device
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_ReadByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t *data)
+{
+	SD_I2C_ReadBytes(I2Cx,device_address, register_address, 1, data);
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+
+
+/** Read multiple bytes from an 8-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address First register regAddr to read from
+ * @param count Number of bytes to read
+ * @param data Buffer to store read data in
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_ReadBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address
+		, uint8_t register_address, uint8_t count, uint8_t *data)
+{
+	return SD_I2C_TransmitReceive(I2Cx, device_address << 1, &register_address, 1, data, count);
+}
+/** Write single word to a 16-bit device register.
+ * @param devAddr I2C slave device address
+ * @param regAddr Register address to write to
+ * @param data New word value to write
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t *data)
+{
+	SD_I2C_ReadWords(I2Cx,device_address,register_address,1,data);
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+/** Read multiple words from a 16-bit device register.
+ * @param device_address I2C slave device address
+ * @param register_address First register regAddr to read from
+ * @param length Number of words to read
+ * @param data Buffer to store read data in
+ * @return One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadWords(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address
+		, uint8_t length,uint16_t *data)
+{
+//	uint8_t count;
+//	uint8_t AWord[2];
+//
+//	for (count = 0; count < length; count++) {
+//		SD_I2C_ReadSome(I2Cx,device_address,register_address,1,&AWord[0]);
+//		SD_I2C_ReadSome(I2Cx,device_address,register_address,1,&AWord[1]);
+//
+//		uint16_t DataBits = (( AWord[0]<<8 )| AWord[1] );
+//		*data++ = DataBits;
+//		}
+//	/* Return OK */
+	return SD_I2C_TransmitReceive(I2Cx, device_address << 1, &register_address, 1, (uint8_t *)data, length*2);
+}
+/**
+ * @brief  Reads I2C data without specifying register address
+ * @note   This can be used if your sensors just sends data, without any registers
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  *data: Pointer to variable where data will be stored from read operation
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data)
+{
+	/* Receive single byte without specifying  */
+	return SD_I2C_Receive(I2Cx, device_address, data, 1);
+}
+/**
+ * @brief  Reads multiple bytes from device without specifying register address
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  *data: Pointer to variable where data will be stored from read operation
+ * @param  count: Number of elements to read from device
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadSomeWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count)
+{
+	/* Receive multi bytes without specifying  */
+	return SD_I2C_Receive(I2Cx, device_address, data, count);
+}
+/**
+ * @brief  Reads single byte from device with 16-bit register address
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register address from where read will be done
+ * @param  *data: Pointer to variable where data will be stored from read operation
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t* data) {
+	uint8_t adr[2];
+
+	/* Format I2C address */
+	adr[0] = (register_address >> 8) & 0xFF; /* High byte */
+	adr[1] = (register_address) & 0xFF;      /* Low byte */
+
+	/* Send address, then receive byte */
+	return SD_I2C_TransmitReceive(I2Cx, device_address, adr, 2, data, 1);
+}
+
+/* Transaction chain statistics */
+static SD_I2C_ChainStats SD_I2C_ChainStatistics;
+
+/**
+ * @brief  Estimates SCL clocks needed by a read or write chain step
+ * @param  *step: Pointer to chain step
+ * @retval Number of SCL clocks including start, restart and stop conditions
+ */
+static uint32_t SD_I2C_ChainStepClocks(const SD_I2C_ChainStep* step)
+{
+	uint32_t address_bytes = step->register_size == I2C_MEMADD_SIZE_16BIT ? 2 : 1;
+
+	/* Start, device address, register address, data bytes and stop, 9 clocks per byte */
+	uint32_t clocks = 1 + 9 + 9 * address_bytes + 9 * (uint32_t)step->count + 1;
+
+	/* Reads add a restart and a second device address */
+	if (step->op == SD_I2C_ChainOp_Read)
+	{
+		clocks += 1 + 9;
+	}
+
+	return clocks;
+}
+
+/**
+ * @brief  Runs a chain of transactions back to back without returning to the caller between them
+ * @note   Condition steps test a byte already in memory, so a chain like
+ *         "read status; stop if clear; read data" goes on to the data read without returning to the caller
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  *steps: Pointer to array of chain steps
+ * @param  count: Number of steps in array
+ * @param  *completed: Number of steps processed before chain ended, can be NULL
+ * @retval One of @ref SD_I2C_Result enumeration, stopping on a condition step is not an error
+ */
+SD_I2C_Result SD_I2C_RunChain(I2C_HandleTypeDef* I2Cx, const SD_I2C_ChainStep* steps, uint8_t count, uint8_t* completed)
+{
+	SD_I2C_Result result;
+	uint8_t i;
+	uint8_t stop = 0;
+
+	SD_I2C_ChainStatistics.chains++;
+
+	for (i = 0; i < count && !stop; i++)
+	{
+		const SD_I2C_ChainStep* step = &steps[i];
+
+		switch (step->op)
+		{
+		case SD_I2C_ChainOp_Read:
+			SD_I2C_ChainStatistics.transfers++;
+			result = SD_I2C_MemRead(I2Cx, step->device_address, step->register_address, step->register_size, step->data, step->count);
+			if (result != SD_I2C_Result_Ok)
+			{
+				if (completed != NULL)
+					*completed = i;
+				return result;
+			}
+			break;
+
+		case SD_I2C_ChainOp_Write:
+			SD_I2C_ChainStatistics.transfers++;
+			result = SD_I2C_MemWrite(I2Cx, step->device_address, step->register_address, step->register_size, step->data, step->count);
+			if (result != SD_I2C_Result_Ok)
+			{
+				if (completed != NULL)
+					*completed = i;
+				return result;
+			}
+			break;
+
+		case SD_I2C_ChainOp_StopIfClear:
+			stop = (step->data[0] & step->mask) == 0;
+			break;
+
+		case SD_I2C_ChainOp_StopIfSet:
+			stop = (step->data[0] & step->mask) != 0;
+			break;
+
+		default:
+			if (completed != NULL)
+				*completed = i;
+			return SD_I2C_Result_Error;
+		}
+	}
+
+	if (completed != NULL)
+		*completed = i;
+
+	/* Account for the transfers the condition saved */
+	if (stop)
+	{
+		SD_I2C_ChainStatistics.stopped++;
+		for (; i < count; i++)
+		{
+			if (steps[i].op == SD_I2C_ChainOp_Read)
+			{
+				SD_I2C_ChainStatistics.skipped_reads++;
+				SD_I2C_ChainStatistics.saved_clocks += SD_I2C_ChainStepClocks(&steps[i]);
+			}
+			else if (steps[i].op == SD_I2C_ChainOp_Write)
+			{
+				SD_I2C_ChainStatistics.skipped_writes++;
+				SD_I2C_ChainStatistics.saved_clocks += SD_I2C_ChainStepClocks(&steps[i]);
+			}
+		}
+	}
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Reads a status register and reads a data block only if any of the masked status bits is set
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  status_register: Register address of status (data-ready) flags
+ * @param  mask: Status bits that signal new data
+ * @param  data_register: Register address from where data read will start
+ * @param  register_size: Register address width of both registers, I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT
+ * @param  count: Number of data bytes to read
+ * @param  *status: Pointer to variable where status byte will be stored, test it with mask to know if data was read
+ * @param  *data: Pointer to buffer where data will be stored
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_ReadIfSet(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t status_register, uint8_t mask
+		, uint16_t data_register, uint16_t register_size, uint16_t count, uint8_t* status, uint8_t* data)
+{
+	SD_I2C_ChainStep steps[3] = {
+		{ SD_I2C_ChainOp_Read,        device_address, status_register, register_size, 1,     0,    status },
+		{ SD_I2C_ChainOp_StopIfClear, device_address, 0,               register_size, 0,     mask, status },
+		{ SD_I2C_ChainOp_Read,        device_address, data_register,   register_size, count, 0,    data   },
+	};
+
+	return SD_I2C_RunChain(I2Cx, steps, 3, NULL);
+}
+
+/**
+ * @brief  Copies transaction chain statistics
+ * @param  *stats: Pointer to structure where statistics will be stored
+ * @retval None
+ */
+void SD_I2C_GetChainStats(SD_I2C_ChainStats* stats)
+{
+	*stats = SD_I2C_ChainStatistics;
+}
+
+/**
+ * @brief  Clears transaction chain statistics
+ * @retval None
+ */
+void SD_I2C_ResetChainStats(void)
+{
+	memset(&SD_I2C_ChainStatistics, 0, sizeof(SD_I2C_ChainStatistics));
+}
+
+/* General call commands reserved by the I2C specification */
+#define SD_I2C_GENERAL_CALL_LATCH    0x04
+#define SD_I2C_GENERAL_CALL_RESET    0x06
+
+/* Number of bytes read back at once when verifying group writes */
+#define SD_I2C_GROUP_VERIFY_CHUNK    16
+
+/**
+ * @brief  Reads back data written to a device and compares it
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register address where data was written
+ * @param  size: Register address width, I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT
+ * @param  count: Number of bytes to compare
+ * @param  *data: Data that was written
+ * @retval One of @ref SD_I2C_Result enumeration, SD_I2C_Result_Error on mismatch
+ */
+static SD_I2C_Result SD_I2C_GroupVerify(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address
+		, uint16_t size, uint16_t count, uint8_t* data)
+{
+	uint8_t buffer[SD_I2C_GROUP_VERIFY_CHUNK];
+	uint16_t offset;
+	uint16_t chunk;
+	SD_I2C_Result result;
+
+	for (offset = 0; offset < count; offset += chunk)
+	{
+		chunk = count - offset;
+		if (chunk > SD_I2C_GROUP_VERIFY_CHUNK)
+			chunk = SD_I2C_GROUP_VERIFY_CHUNK;
+
+		result = SD_I2C_MemRead(I2Cx, device_address, register_address + offset, size, buffer, chunk);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+
+		if (memcmp(buffer, data + offset, chunk) != 0)
+			return SD_I2C_Result_Error;
+	}
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Picks next group member to access, preferring members using current SCL timing
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  *group: Pointer to group description
+ * @param  *done: Bitmap of members already accessed, next member is marked in it
+ * @retval Index of next member, or group->device_count if every member was accessed
+ */
+static uint8_t SD_I2C_GroupNext(I2C_HandleTypeDef* I2Cx, const SD_I2C_Group* group, uint8_t* done)
+{
+	uint8_t next = group->device_count;
+	uint8_t i;
+
+	for (i = 0; i < group->device_count; i++)
+	{
+		if (done[i >> 3] & (1 << (i & 7)))
+			continue;
+
+		if (next == group->device_count)
+			next = i;
+
+		if (SD_I2C_GetDeviceTiming(I2Cx, group->device_addresses[i]) == I2Cx->Init.Timing)
+		{
+			next = i;
+			break;
+		}
+	}
+
+	if (next != group->device_count)
+		done[next >> 3] |= 1 << (next & 7);
+
+	return next;
+}
+
+/**
+ * @brief  Writes group broadcast at the SCL timing of the slowest device it reaches
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  *group: Pointer to group description, general call or all-call mode
+ * @param  register_address: Register address where data will be written, all-call only
+ * @param  count: Number of bytes to write
+ * @param  *data: Data to be written to devices
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+static SD_I2C_Result SD_I2C_GroupBroadcast(I2C_HandleTypeDef* I2Cx, const SD_I2C_Group* group, uint16_t register_address
+		, uint16_t count, uint8_t* data)
+{
+	uint32_t timing = SD_I2C_GroupTiming(I2Cx, group);
+	HAL_StatusTypeDef status;
+
+	if (timing != I2Cx->Init.Timing)
+		SD_I2C_SetBusTiming(I2Cx, timing);
+
+	if (group->mode == SD_I2C_GroupMode_GeneralCall)
+		status = HAL_I2C_Master_Transmit(I2Cx, SD_I2C_GENERAL_CALL_ADDRESS, data, count, 1000);
+	else
+		status = HAL_I2C_Mem_Write(I2Cx, group->all_call_address, register_address, group->register_size, data, count, 1000);
+
+	if (status != HAL_OK)
+		return SD_I2C_CheckError(I2Cx);
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Writes the same data to every device of a group
+ * @note   General call and all-call groups are written with a single transfer. If that transfer
+ *         is not acknowledged, or the group is a fan-out group, every device is written back to back.
+ *         Verification reads run only after all writes, so devices are updated as close together as possible.
+ * @note   General call groups send data as is after the general call address, in the part's own
+ *         general-call command format, and register_address is ignored. A command is not register
+ *         data, so general call groups have no fan-out fallback and cannot be verified per device,
+ *         verify must be zero. A first byte of 0x00 (not allowed), 0x04 (latch programmable address),
+ *         0x06 (reset and latch) or with bit 0 set (hardware general call, byte is a master address)
+ *         is rejected.
+ * @note   Broadcasts run at the slowest SCL timing of the devices they reach.
+ * @note   An acknowledged broadcast only proves that some device answered. Without verify, every
+ *         member's result is then SD_I2C_Result_Ok although members were not checked one by one.
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  *group: Pointer to group description
+ * @param  register_address: Register address where data will be written, unused by general call groups
+ * @param  count: Number of bytes to write
+ * @param  *data: Data to be written to devices, general-call command for general call groups
+ * @param  verify: Non-zero to read data back from every device, must be zero for general call groups
+ * @param  *results: Array of group->device_count results, one per device, can be NULL
+ * @retval SD_I2C_Result_Ok if every device succeeded, otherwise first failing device's result,
+ *         SD_I2C_Result_Error without bus access if a general call is rejected
+ */
+SD_I2C_Result SD_I2C_GroupWrite(I2C_HandleTypeDef* I2Cx, const SD_I2C_Group* group, uint16_t register_address
+		, uint16_t count, uint8_t* data, uint8_t verify, SD_I2C_Result* results)
+{
+	SD_I2C_Result result = SD_I2C_Result_Ok;
+	SD_I2C_Result broadcast = SD_I2C_Result_Error;
+	SD_I2C_Result r;
+	uint8_t done[32];
+	uint8_t failed[32];
+	uint8_t i;
+
+	/* General call carries a command, which cannot be read back, and reserved
+	   or hardware general call bytes would reach every device on the bus */
+	if (group->mode == SD_I2C_GroupMode_GeneralCall
+			&& (verify || count == 0 || data[0] == 0x00 || (data[0] & 0x01)
+				|| data[0] == SD_I2C_GENERAL_CALL_LATCH || data[0] == SD_I2C_GENERAL_CALL_RESET))
+	{
+		if (results != NULL)
+		{
+			for (i = 0; i < group->device_count; i++)
+				results[i] = SD_I2C_Result_Error;
+		}
+		return SD_I2C_Result_Error;
+	}
+
+	/* Try single broadcast write */
+	if (group->mode != SD_I2C_GroupMode_FanOut)
+		broadcast = SD_I2C_GroupBroadcast(I2Cx, group, register_address, count, data);
+
+	/* Fall back to writing devices one after another, grouped by SCL timing,
+	   general call commands have no register equivalent */
+	memset(done, 0, sizeof(done));
+	memset(failed, 0, sizeof(failed));
+	while ((i = SD_I2C_GroupNext(I2Cx, group, done)) < group->device_count)
+	{
+		r = broadcast;
+		if (r != SD_I2C_Result_Ok && group->mode != SD_I2C_GroupMode_GeneralCall)
+			r = SD_I2C_MemWrite(I2Cx, group->device_addresses[i], register_address, group->register_size, data, count);
+
+		if (results != NULL)
+			results[i] = r;
+		if (r != SD_I2C_Result_Ok)
+		{
+			failed[i >> 3] |= 1 << (i & 7);
+			if (result == SD_I2C_Result_Ok)
+				result = r;
+		}
+	}
+
+	/* Read back every device that was written */
+	if (verify)
+	{
+		memset(done, 0, sizeof(done));
+		while ((i = SD_I2C_GroupNext(I2Cx, group, done)) < group->device_count)
+		{
+			if (failed[i >> 3] & (1 << (i & 7)))
+				continue;
+
+			r = SD_I2C_GroupVerify(I2Cx, group->device_addresses[i], register_address, group->register_size, count, data);
+
+			if (results != NULL)
+				results[i] = r;
+			if (r != SD_I2C_Result_Ok && result == SD_I2C_Result_Ok)
+				result = r;
+		}
+	}
+
+	return result;
+}
+
+/* Mask of writable TIMINGR bits */
+#define SD_I2C_TIMING_MASK    0xF0FFFFFF
+
+/* SCL timing of one device */
+typedef struct {
+	I2C_HandleTypeDef* I2Cx;
+	uint8_t            device_address;
+	uint32_t           timing;
+} SD_I2C_TimingProfile;
+
+/* SCL timing a peripheral was initialized with, used by devices without profile */
+typedef struct {
+	I2C_HandleTypeDef* I2Cx;
+	uint32_t           timing;
+} SD_I2C_TimingBus;
+
+static SD_I2C_TimingProfile SD_I2C_TimingProfiles[SD_I2C_MAX_TIMING_PROFILES];
+static uint8_t SD_I2C_TimingProfileCount;
+static SD_I2C_TimingBus SD_I2C_TimingBuses[SD_I2C_MAX_TIMING_BUSES];
+static uint8_t SD_I2C_TimingBusCount;
+static uint32_t SD_I2C_TimingSwitches;
+
+/**
+ * @brief  Reprograms SCL timing of I2Cx peripheral
+ * @note   TIMINGR can only be written while peripheral is disabled
+ * @param  *I2Cx: Pointer to I2Cx peripheral
+ * @param  timing: New TIMINGR value
+ * @retval None
+ */
+static void SD_I2C_SetBusTiming(I2C_HandleTypeDef* I2Cx, uint32_t timing)
+{
+	__HAL_I2C_DISABLE(I2Cx);
+	I2Cx->Instance->TIMINGR = timing & SD_I2C_TIMING_MASK;
+	__HAL_I2C_ENABLE(I2Cx);
+
+	I2Cx->Init.Timing = timing;
+	SD_I2C_TimingSwitches++;
+}
+
+/**
+ * @brief  Switches SCL timing to the one of device, if it differs from current timing
+ * @note   Called before every transfer, also by the C++ interface in sd_hal_i2c.hpp
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @retval None
+ */
+void SD_I2C_ApplyTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address)
+{
+	uint32_t timing;
+
+	/* Nothing to do until a bus uses per-device timing */
+	if (SD_I2C_TimingBusCount == 0)
+		return;
+
+	timing = SD_I2C_GetDeviceTiming(I2Cx, device_address);
+	if (timing != I2Cx->Init.Timing)
+		SD_I2C_SetBusTiming(I2Cx, timing);
+}
+
+/**
+ * @brief  Remembers timing I2Cx peripheral was initialized with
+ * @param  *I2Cx: Pointer to I2Cx peripheral
+ * @retval SD_I2C_Result_Ok, or SD_I2C_Result_Error if bus table is full
+ */
+static SD_I2C_Result SD_I2C_AddTimingBus(I2C_HandleTypeDef* I2Cx)
+{
+	uint8_t i;
+
+	for (i = 0; i < SD_I2C_TimingBusCount; i++)
+	{
+		if (SD_I2C_TimingBuses[i].I2Cx == I2Cx)
+			return SD_I2C_Result_Ok;
+	}
+
+	if (SD_I2C_TimingBusCount == SD_I2C_MAX_TIMING_BUSES)
+		return SD_I2C_Result_Error;
+
+	SD_I2C_TimingBuses[i].I2Cx = I2Cx;
+	SD_I2C_TimingBuses[i].timing = I2Cx->Init.Timing;
+	SD_I2C_TimingBusCount++;
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Switches I2Cx peripheral back to the timing it was initialized with
+ * @param  *I2Cx: Pointer to I2Cx peripheral
+ * @retval None
+ */
+static void SD_I2C_RestoreBusTiming(I2C_HandleTypeDef* I2Cx)
+{
+	uint8_t i;
+
+	for (i = 0; i < SD_I2C_TimingBusCount; i++)
+	{
+		if (SD_I2C_TimingBuses[i].I2Cx == I2Cx && SD_I2C_TimingBuses[i].timing != I2Cx->Init.Timing)
+			SD_I2C_SetBusTiming(I2Cx, SD_I2C_TimingBuses[i].timing);
+	}
+}
+
+/**
+ * @brief  Approximates SCL period of a TIMINGR value
+ * @param  timing: TIMINGR value
+ * @retval SCL period in I2C kernel clocks, without rise and fall times
+ */
+static uint32_t SD_I2C_TimingPeriod(uint32_t timing)
+{
+	/* (PRESC + 1) * (SCLL + 1 + SCLH + 1) */
+	return ((timing >> 28) + 1) * ((timing & 0xFF) + ((timing >> 8) & 0xFF) + 2);
+}
+
+/**
+ * @brief  Gets slowest SCL timing of devices a group broadcast reaches
+ * @note   General call reaches every device on the bus, so every profile of the bus counts
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  *group: Pointer to group description
+ * @retval TIMINGR value for broadcast
+ */
+static uint32_t SD_I2C_GroupTiming(I2C_HandleTypeDef* I2Cx, const SD_I2C_Group* group)
+{
+	uint32_t timing;
+	uint32_t t;
+	uint8_t i;
+
+	if (group->mode == SD_I2C_GroupMode_GeneralCall)
+	{
+		timing = SD_I2C_GetDeviceTiming(I2Cx, SD_I2C_GENERAL_CALL_ADDRESS);
+		for (i = 0; i < SD_I2C_TimingProfileCount; i++)
+		{
+			t = SD_I2C_TimingProfiles[i].timing;
+			if (SD_I2C_TimingProfiles[i].I2Cx == I2Cx && SD_I2C_TimingPeriod(t) > SD_I2C_TimingPeriod(timing))
+				timing = t;
+		}
+	}
+	else
+	{
+		timing = SD_I2C_GetDeviceTiming(I2Cx, group->all_call_address);
+		for (i = 0; i < group->device_count; i++)
+		{
+			t = SD_I2C_GetDeviceTiming(I2Cx, group->device_addresses[i]);
+			if (SD_I2C_TimingPeriod(t) > SD_I2C_TimingPeriod(timing))
+				timing = t;
+		}
+	}
+
+	return timing;
+}
+
+/**
+ * @brief  Sets SCL timing used for every transfer to a device
+ * @note   Timing is applied between transfers, devices without timing use the timing I2Cx was initialized with
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  timing: TIMINGR value for device
+ * @retval SD_I2C_Result_Ok, or SD_I2C_Result_Error if profile table is full
+ */
+SD_I2C_Result SD_I2C_SetDeviceTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint32_t timing)
+{
+	uint8_t i;
+
+	if (SD_I2C_AddTimingBus(I2Cx) != SD_I2C_Result_Ok)
+		return SD_I2C_Result_Error;
+
+	/* Update existing profile */
+	for (i = 0; i < SD_I2C_TimingProfileCount; i++)
+	{
+		if (SD_I2C_TimingProfiles[i].I2Cx == I2Cx && SD_I2C_TimingProfiles[i].device_address == device_address)
+		{
+			SD_I2C_TimingProfiles[i].timing = timing;
+			return SD_I2C_Result_Ok;
+		}
+	}
+
+	/* Add new profile */
+	if (SD_I2C_TimingProfileCount == SD_I2C_MAX_TIMING_PROFILES)
+		return SD_I2C_Result_Error;
+
+	SD_I2C_TimingProfiles[i].I2Cx = I2Cx;
+	SD_I2C_TimingProfiles[i].device_address = device_address;
+	SD_I2C_TimingProfiles[i].timing = timing;
+	SD_I2C_TimingProfileCount++;
+
+	/* Return OK */
+	return SD_I2C_Result_Ok;
+}
+
+/**
+ * @brief  Gets SCL timing used for transfers to a device
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @retval TIMINGR value for device
+ */
+uint32_t SD_I2C_GetDeviceTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address)
+{
+	uint8_t i;
+
+	for (i = 0; i < SD_I2C_TimingProfileCount; i++)
+	{
+		if (SD_I2C_TimingProfiles[i].I2Cx == I2Cx && SD_I2C_TimingProfiles[i].device_address == device_address)
+			return SD_I2C_TimingProfiles[i].timing;
+	}
+
+	for (i = 0; i < SD_I2C_TimingBusCount; i++)
+	{
+		if (SD_I2C_TimingBuses[i].I2Cx == I2Cx)
+			return SD_I2C_TimingBuses[i].timing;
+	}
+
+	return I2Cx->Init.Timing;
+}
+
+/**
+ * @brief  Finds fastest SCL timing a device reads back reliably and sets it as device timing
+ * @note   Reference value is read with the last (slowest) timing, then every timing from the first
+ *         on must return the same value trials times in a row
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @param  register_address: Register with a constant value, an identification register for example
+ * @param  register_size: Register address width, I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT
+ * @param  *timings: Candidate TIMINGR values, fastest first, last one known to work
+ * @param  count: Number of candidate timings
+ * @param  trials: Number of reads each timing must pass
+ * @param  *timing: Pointer to variable where chosen timing will be stored
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+SD_I2C_Result SD_I2C_TuneDeviceTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address
+		, uint16_t register_size, const uint32_t* timings, uint8_t count, uint8_t trials, uint32_t* timing)
+{
+	SD_I2C_Result result = SD_I2C_Result_Error;
+	uint8_t reference;
+	uint8_t b;
+	uint8_t i;
+	uint8_t t;
+
+	if (count == 0 || trials == 0 || SD_I2C_AddTimingBus(I2Cx) != SD_I2C_Result_Ok)
+		return SD_I2C_Result_Error;
+
+	/* Read reference value with safe timing */
+	SD_I2C_SetBusTiming(I2Cx, timings[count - 1]);
+	if (HAL_I2C_Mem_Read(I2Cx, (uint16_t)device_address, register_address, register_size, &reference, 1, 1000) == HAL_OK)
+	{
+		for (i = 0; i < count; i++)
+		{
+			SD_I2C_SetBusTiming(I2Cx, timings[i]);
+
+			for (t = 0; t < trials; t++)
+			{
+				if (HAL_I2C_Mem_Read(I2Cx, (uint16_t)device_address, register_address, register_size, &b, 1, 1000) != HAL_OK || b != reference)
+					break;
+			}
+
+			if (t == trials)
+			{
+				*timing = timings[i];
+				result = SD_I2C_SetDeviceTiming(I2Cx, device_address, timings[i]);
+				break;
+			}
+		}
+	}
+	else
+	{
+		result = SD_I2C_CheckError(I2Cx);
+	}
+
+	/* Leave bus on its own timing, device timing is applied on next transfer */
+	SD_I2C_RestoreBusTiming(I2Cx);
+
+	return result;
+}
+
+/**
+ * @brief  Gets number of times SCL timing was reprogrammed
+ * @retval Number of timing switches
+ */
+uint32_t SD_I2C_GetTimingSwitches(void)
+{
+	return SD_I2C_TimingSwitches;
+}
@@ -1,105 +1,191 @@
-/*
- * sd_hal_i2c.h
- *
- *  Created on: Mar 5, 2016
- *      Author: Sina Darvishi
- */
-
-#ifndef DRIVERS_MYLIB_SD_HAL_I2C_H_
-#define DRIVERS_MYLIB_SD_HAL_I2C_H_
-
-
-/* C++ detection */
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-
-#include "stm32f0xx_hal.h"
-#include <stdint.h>
-#include <stdlib.h>
-#include <string.h>
-
- /**
- * @}
- */
-
-/**
- * @defgroup SD_I2C_Typedefs
- * @brief    Library Typedefs
- * @{
- */
-
-
-/**
- * @brief  I2C result enumeration
- */
-typedef enum {
-	SD_I2C_Result_Ok       = 0x00,     /*!< Everything OK */
-	SD_I2C_Result_Error    = 0x01,     /*!< An error has occurred */
-	SD_I2C_Result_Busy     = 0x02,	   /*!< I2C is Busy */
-	SD_I2C_Result_BERR     = 0x03,     /*!< BERR error */
-	SD_I2C_Result_ARLO     = 0x04,     /*!< ARLO error */
-	SD_I2C_Result_AF       = 0x05,     /*!< ACKF error */
-	SD_I2C_Result_OVR      = 0x06,     /*!< OVR error */
-	SD_I2C_Result_DMA      = 0x07,     /*!< DMA error */
-	SD_I2C_Result_TIMEOUT  = 0x08,     /*!< Timeout error */
-	SD_I2C_Result_SIZE     = 0x09,     /*!< Size Management error */
-} SD_I2C_Result;
-
-/**
- * @}
- */
-
-/**
- * @defgroup SD_I2C_Functions
- * @brief    Library Functions
- * @{
- */
-
-
-/**
- * @brief  Checks if device is connected to I2C and ready to use
- * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
- * @param  device_address: 7-bit, left aligned device address used for communication
- * @retval One of @ref SD_I2C_Result enumeration
- */
-
-SD_I2C_Result SD_I2C_CheckError(I2C_HandleTypeDef* I2Cx);
-SD_I2C_Result SD_I2C_IsDeviceConnected(I2C_HandleTypeDef* I2Cx, uint8_t address);
-SD_I2C_Result SD_I2C_WriteBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum, uint8_t data);
-SD_I2C_Result SD_I2C_WriteBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t data);
-SD_I2C_Result SD_I2C_WriteBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t data);
-SD_I2C_Result SD_I2C_WriteBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t data);
-SD_I2C_Result SD_I2C_Write(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data);
-SD_I2C_Result SD_I2C_WriteSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint16_t count, uint8_t *data);
-SD_I2C_Result SD_I2C_WriteByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data);
-SD_I2C_Result SD_I2C_WriteBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t count, uint8_t *data);
-SD_I2C_Result SD_I2C_WriteWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t data);
-SD_I2C_Result SD_I2C_WriteWords(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t length,uint16_t *data);
-SD_I2C_Result SD_I2C_WriteWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t data);
-SD_I2C_Result SD_I2C_WriteMultiWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count);
-SD_I2C_Result SD_I2C_WriteWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t data);
-SD_I2C_Result SD_I2C_ReadBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum, uint8_t *data);
-SD_I2C_Result SD_I2C_ReadBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t *data);
-SD_I2C_Result SD_I2C_ReadBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t *data);
-SD_I2C_Result SD_I2C_ReadBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t *data);
-SD_I2C_Result SD_I2C_Read(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t *data);
-SD_I2C_Result SD_I2C_ReadSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint16_t count, uint8_t *data);
-SD_I2C_Result SD_I2C_ReadByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t *data);
-SD_I2C_Result SD_I2C_ReadBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t count, uint8_t *data);
-SD_I2C_Result SD_I2C_ReadWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t *data);
-SD_I2C_Result SD_I2C_ReadWords(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t length,uint16_t *data);
-SD_I2C_Result SD_I2C_ReadWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data);
-SD_I2C_Result SD_I2C_ReadSomeWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count);
-SD_I2C_Result SD_I2C_ReadWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t* data);
-/**
- * @}
- */
-
-/* C++ detection */
-#ifdef __cplusplus
-}
-#endif
-
-#endif /* DRIVERS_MYLIB_SD_HAL_I2C_H_ */
+/*
+ * sd_hal_i2c.h
+ *
+ *  Created on: Mar 5, 2016
+ *      Author: Sina Darvishi
+ */
+
+#ifndef DRIVERS_MYLIB_SD_HAL_I2C_H_
+#define DRIVERS_MYLIB_SD_HAL_I2C_H_
+
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+ /**
+ * @}
+ */
+
+/**
+ * @defgroup SD_I2C_Typedefs
+ * @brief    Library Typedefs
+ * @{
+ */
+
+
+/**
+ * @brief  I2C result enumeration
+ */
+typedef enum {
+	SD_I2C_Result_Ok       = 0x00,     /*!< Everything OK */
+	SD_I2C_Result_Error    = 0x01,     /*!< An error has occurred */
+	SD_I2C_Result_Busy     = 0x02,	   /*!< I2C is Busy */
+	SD_I2C_Result_BERR     = 0x03,     /*!< BERR error */
+	SD_I2C_Result_ARLO     = 0x04,     /*!< ARLO error */
+	SD_I2C_Result_AF       = 0x05,     /*!< ACKF error */
+	SD_I2C_Result_OVR      = 0x06,     /*!< OVR error */
+	SD_I2C_Result_DMA      = 0x07,     /*!< DMA error */
+	SD_I2C_Result_TIMEOUT  = 0x08,     /*!< Timeout error */
+	SD_I2C_Result_SIZE     = 0x09,     /*!< Size Management error */
+} SD_I2C_Result;
+
+/**
+ * @brief  Operation performed by one step of a transaction chain
+ */
+typedef enum {
+	SD_I2C_ChainOp_Read        = 0x00, /*!< Read count bytes starting at register_address into data */
+	SD_I2C_ChainOp_Write       = 0x01, /*!< Write count bytes from data starting at register_address */
+	SD_I2C_ChainOp_StopIfClear = 0x02, /*!< Stop chain if (data[0] & mask) is zero, no bus access */
+	SD_I2C_ChainOp_StopIfSet   = 0x03, /*!< Stop chain if (data[0] & mask) is not zero, no bus access */
+} SD_I2C_ChainOp;
+
+/**
+ * @brief  One step of a transaction chain
+ * @note   Condition steps usually point data at the buffer of an earlier read step
+ */
+typedef struct {
+	SD_I2C_ChainOp op;               /*!< Operation of this step */
+	uint8_t        device_address;   /*!< 7-bit, left aligned device address used for communication */
+	uint16_t       register_address; /*!< Register address */
+	uint16_t       register_size;    /*!< Register address width, I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT */
+	uint16_t       count;            /*!< Number of bytes to transfer */
+	uint8_t        mask;             /*!< Bit mask tested by condition steps */
+	uint8_t*       data;             /*!< Transfer buffer, or byte tested by condition steps */
+} SD_I2C_ChainStep;
+
+/**
+ * @brief  Transaction chain statistics
+ * @note   Bus time is counted in SCL clocks, divide by bus frequency to get seconds
+ */
+typedef struct {
+	uint32_t chains;          /*!< Number of chains run */
+	uint32_t stopped;         /*!< Number of chains stopped early by a condition step */
+	uint32_t transfers;       /*!< Number of bus transfers issued */
+	uint32_t skipped_reads;   /*!< Number of read steps skipped by a condition step */
+	uint32_t skipped_writes;  /*!< Number of write steps skipped by a condition step */
+	uint32_t saved_clocks;    /*!< Estimated SCL clocks not spent because of skipped steps */
+} SD_I2C_ChainStats;
+
+/**
+ * @brief  General call address, left aligned
+ */
+#define SD_I2C_GENERAL_CALL_ADDRESS    0x00
+
+/**
+ * @brief  How a group write reaches the devices of a group
+ */
+typedef enum {
+	SD_I2C_GroupMode_FanOut      = 0x00, /*!< Write each device in turn */
+	SD_I2C_GroupMode_GeneralCall = 0x01, /*!< Single general-call command, sent as raw bytes, not verifiable per device */
+	SD_I2C_GroupMode_AllCall     = 0x02, /*!< Single write to device specific all-call address */
+} SD_I2C_GroupMode;
+
+/**
+ * @brief  Group of identical devices written together
+ */
+typedef struct {
+	const uint8_t*   device_addresses;  /*!< 7-bit, left aligned addresses of group members */
+	uint8_t          device_count;      /*!< Number of group members */
+	SD_I2C_GroupMode mode;              /*!< How group members are reached */
+	uint8_t          all_call_address;  /*!< 7-bit, left aligned all-call address, used in @ref SD_I2C_GroupMode_AllCall */
+	uint16_t         register_size;     /*!< Register address width, I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT */
+} SD_I2C_Group;
+
+/**
+ * @brief  Maximum number of devices with their own SCL timing
+ */
+#ifndef SD_I2C_MAX_TIMING_PROFILES
+#define SD_I2C_MAX_TIMING_PROFILES    8
+#endif
+
+/**
+ * @brief  Maximum number of I2C peripherals using per-device SCL timing
+ */
+#ifndef SD_I2C_MAX_TIMING_BUSES
+#define SD_I2C_MAX_TIMING_BUSES       2
+#endif
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup SD_I2C_Functions
+ * @brief    Library Functions
+ * @{
+ */
+
+
+/**
+ * @brief  Checks if device is connected to I2C and ready to use
+ * @param  *I2Cx: Pointer to I2Cx peripheral to be used in communication
+ * @param  device_address: 7-bit, left aligned device address used for communication
+ * @retval One of @ref SD_I2C_Result enumeration
+ */
+
+SD_I2C_Result SD_I2C_CheckError(I2C_HandleTypeDef* I2Cx);
+SD_I2C_Result SD_I2C_IsDeviceConnected(I2C_HandleTypeDef* I2Cx, uint8_t address);
+SD_I2C_Result SD_I2C_WriteBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum, uint8_t data);
+SD_I2C_Result SD_I2C_WriteBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t data);
+SD_I2C_Result SD_I2C_WriteBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t data);
+SD_I2C_Result SD_I2C_WriteBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t data);
+SD_I2C_Result SD_I2C_Write(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data);
+SD_I2C_Result SD_I2C_WriteSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint16_t count, uint8_t *data);
+SD_I2C_Result SD_I2C_WriteByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t data);
+SD_I2C_Result SD_I2C_WriteBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t count, uint8_t *data);
+SD_I2C_Result SD_I2C_WriteWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t data);
+SD_I2C_Result SD_I2C_WriteWords(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t length,uint16_t *data);
+SD_I2C_Result SD_I2C_WriteWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t data);
+SD_I2C_Result SD_I2C_WriteMultiWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count);
+SD_I2C_Result SD_I2C_WriteWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t data);
+SD_I2C_Result SD_I2C_ReadBit(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum, uint8_t *data);
+SD_I2C_Result SD_I2C_ReadBitW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t bitNum,uint16_t *data);
+SD_I2C_Result SD_I2C_ReadBits(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint8_t *data);
+SD_I2C_Result SD_I2C_ReadBitsW(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint16_t register_address, uint8_t bitStart, uint8_t length,uint16_t *data);
+SD_I2C_Result SD_I2C_Read(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t *data);
+SD_I2C_Result SD_I2C_ReadSome(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint16_t count, uint8_t *data);
+SD_I2C_Result SD_I2C_ReadByte(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t *data);
+SD_I2C_Result SD_I2C_ReadBytes(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t register_address, uint8_t count, uint8_t *data);
+SD_I2C_Result SD_I2C_ReadWord(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address,uint16_t *data);
+SD_I2C_Result SD_I2C_ReadWords(I2C_HandleTypeDef* I2Cx,uint8_t device_address, uint8_t register_address, uint8_t length,uint16_t *data);
+SD_I2C_Result SD_I2C_ReadWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data);
+SD_I2C_Result SD_I2C_ReadSomeWithNoRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint8_t* data, uint16_t count);
+SD_I2C_Result SD_I2C_ReadWith16BitRegisterAddress(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint8_t* data);
+SD_I2C_Result SD_I2C_RunChain(I2C_HandleTypeDef* I2Cx, const SD_I2C_ChainStep* steps, uint8_t count, uint8_t* completed);
+SD_I2C_Result SD_I2C_ReadIfSet(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t status_register, uint8_t mask, uint16_t data_register, uint16_t register_size, uint16_t count, uint8_t* status, uint8_t* data);
+void SD_I2C_GetChainStats(SD_I2C_ChainStats* stats);
+void SD_I2C_ResetChainStats(void);
+SD_I2C_Result SD_I2C_GroupWrite(I2C_HandleTypeDef* I2Cx, const SD_I2C_Group* group, uint16_t register_address, uint16_t count, uint8_t* data, uint8_t verify, SD_I2C_Result* results);
+SD_I2C_Result SD_I2C_SetDeviceTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint32_t timing);
+uint32_t SD_I2C_GetDeviceTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address);
+SD_I2C_Result SD_I2C_TuneDeviceTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address, uint16_t register_address, uint16_t register_size, const uint32_t* timings, uint8_t count, uint8_t trials, uint32_t* timing);
+uint32_t SD_I2C_GetTimingSwitches(void);
+void SD_I2C_ApplyTiming(I2C_HandleTypeDef* I2Cx, uint8_t device_address);
+/**
+ * @}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVERS_MYLIB_SD_HAL_I2C_H_ */
@@ -0,0 +1,281 @@
+/*
+ * sd_hal_i2c.hpp
+ *
+ *  C++ interface with bus, device address, register width and byte order
+ *  fixed at compile time. Every call inlines to a single HAL invocation
+ *  after the per-device timing check.
+ */
+
+#ifndef DRIVERS_MYLIB_SD_HAL_I2C_HPP_
+#define DRIVERS_MYLIB_SD_HAL_I2C_HPP_
+
+#include "sd_hal_i2c.h"
+
+namespace sd_i2c {
+
+/**
+ * @defgroup SD_I2C_Cpp
+ * @brief    C++ interface
+ * @note     Usage:
+ *
+ *           extern I2C_HandleTypeDef hi2c1;
+ *           typedef sd_i2c::Bus<&hi2c1> Bus1;
+ *           typedef sd_i2c::Device<Bus1, 0xD0, 1, sd_i2c::Endian_Big> Mpu6050;
+ *
+ *           uint8_t id;
+ *           Mpu6050::readByte(0x75, &id);
+ *
+ *           Per-device timing profiles set with SD_I2C_SetDeviceTiming apply
+ *           to transfers made through this interface too.
+ * @{
+ */
+
+/**
+ * @brief  Byte order of 16-bit register values
+ */
+enum Endian {
+	Endian_Little = 0x00, /*!< Low byte first, same as SD_I2C_ReadWord/SD_I2C_WriteWord on Cortex-M */
+	Endian_Big    = 0x01, /*!< High byte first */
+};
+
+/**
+ * @brief  I2C bus bound to a HAL handle at compile time
+ * @param  Handle: Pointer to I2Cx peripheral handle, must have static storage
+ * @param  Timeout: Timeout of every transfer in milliseconds
+ */
+template <I2C_HandleTypeDef* Handle, uint32_t Timeout = 1000>
+struct Bus {
+	static I2C_HandleTypeDef* handle() { return Handle; }
+	static uint32_t timeout() { return Timeout; }
+
+	/**
+	 * @brief  Converts HAL status to one of @ref SD_I2C_Result enumeration
+	 */
+	static SD_I2C_Result result(HAL_StatusTypeDef status)
+	{
+		return status == HAL_OK ? SD_I2C_Result_Ok : SD_I2C_CheckError(Handle);
+	}
+};
+
+/**
+ * @brief  I2C device with every addressing option fixed at compile time
+ * @param  B: @ref Bus the device is connected to
+ * @param  Address: 7-bit, left aligned device address used for communication.
+ *         SD_I2C_ReadByte/ReadBytes/ReadWord(s)/WriteByte/WriteBytes/WriteWord(s) and the bit
+ *         functions built on them shift their address left by one, so a device accessed as
+ *         SD_I2C_ReadByte(h, 0x68, ...) is Device<Bus, 0xD0> here.
+ * @param  RegWidth: Register address width in bytes, 0 for devices without registers
+ * @param  E: Byte order of 16-bit register values
+ * @note   Register reads are a single HAL_I2C_Mem_Read: register address write, repeated START,
+ *         read. SD_I2C_Read/ReadByte/ReadBytes/ReadWord(s)/ReadWith16BitRegisterAddress and the
+ *         bit functions built on them send a STOP after the register address and then start a
+ *         separate read. A device that resets its register pointer on STOP, or that does not
+ *         accept a repeated START, reads differently through the two interfaces.
+ *         SD_I2C_ReadSome is the C call with the same bus sequence as readBytes.
+ */
+template <class B, uint8_t Address, uint8_t RegWidth = 1, Endian E = Endian_Little>
+class Device {
+	static_assert(RegWidth <= 2, "register address must be 0, 1 or 2 bytes wide");
+
+	static const uint16_t MemAddSize = RegWidth == 2 ? I2C_MEMADD_SIZE_16BIT : I2C_MEMADD_SIZE_8BIT;
+
+	/* Converts words between host order and device order */
+	static uint16_t order(uint16_t w)
+	{
+		return E == Endian_Big ? (uint16_t)((w >> 8) | (w << 8)) : w;
+	}
+
+public:
+	/**
+	 * @brief  Checks if device is connected to I2C and ready to use
+	 */
+	static SD_I2C_Result isConnected()
+	{
+		SD_I2C_ApplyTiming(B::handle(), Address);
+		return B::result(HAL_I2C_IsDeviceReady(B::handle(), Address, 2, 5));
+	}
+
+	/**
+	 * @brief  Reads multiple bytes starting at register_address
+	 */
+	static SD_I2C_Result readBytes(uint16_t register_address, uint8_t* data, uint16_t count)
+	{
+		static_assert(RegWidth != 0, "device has no registers");
+		SD_I2C_ApplyTiming(B::handle(), Address);
+		return B::result(HAL_I2C_Mem_Read(B::handle(), Address, register_address, MemAddSize, data, count, B::timeout()));
+	}
+
+	/**
+	 * @brief  Writes multiple bytes starting at register_address
+	 */
+	static SD_I2C_Result writeBytes(uint16_t register_address, uint8_t* data, uint16_t count)
+	{
+		static_assert(RegWidth != 0, "device has no registers");
+		SD_I2C_ApplyTiming(B::handle(), Address);
+		return B::result(HAL_I2C_Mem_Write(B::handle(), Address, register_address, MemAddSize, data, count, B::timeout()));
+	}
+
+	/**
+	 * @brief  Reads multiple bytes without register address
+	 */
+	static SD_I2C_Result readBytes(uint8_t* data, uint16_t count)
+	{
+		SD_I2C_ApplyTiming(B::handle(), Address);
+		return B::result(HAL_I2C_Master_Receive(B::handle(), Address, data, count, B::timeout()));
+	}
+
+	/**
+	 * @brief  Writes multiple bytes without register address, can be used for command write
+	 */
+	static SD_I2C_Result writeBytes(uint8_t* data, uint16_t count)
+	{
+		SD_I2C_ApplyTiming(B::handle(), Address);
+		return B::result(HAL_I2C_Master_Transmit(B::handle(), Address, data, count, B::timeout()));
+	}
+
+	static SD_I2C_Result readByte(uint16_t register_address, uint8_t* data) { return readBytes(register_address, data, 1); }
+	static SD_I2C_Result writeByte(uint16_t register_address, uint8_t data) { return writeBytes(register_address, &data, 1); }
+	static SD_I2C_Result readByte(uint8_t* data) { return readBytes(data, 1); }
+	static SD_I2C_Result writeByte(uint8_t data) { return writeBytes(&data, 1); }
+
+	/**
+	 * @brief  Reads multiple 16-bit words starting at register_address, converted to host order
+	 */
+	static SD_I2C_Result readWords(uint16_t register_address, uint16_t* data, uint16_t count)
+	{
+		SD_I2C_Result result = readBytes(register_address, (uint8_t*)data, count * 2);
+		if (E == Endian_Big)
+		{
+			for (uint16_t i = 0; i < count; i++)
+				data[i] = order(data[i]);
+		}
+		return result;
+	}
+
+	/**
+	 * @brief  Writes single 16-bit word to register_address
+	 */
+	static SD_I2C_Result writeWord(uint16_t register_address, uint16_t data)
+	{
+		data = order(data);
+		return writeBytes(register_address, (uint8_t*)&data, 2);
+	}
+
+	static SD_I2C_Result readWord(uint16_t register_address, uint16_t* data) { return readWords(register_address, data, 1); }
+
+	/**
+	 * @brief  Reads a single bit, same as SD_I2C_ReadBit the bit is masked but not shifted
+	 */
+	static SD_I2C_Result readBit(uint16_t register_address, uint8_t bitNum, uint8_t* data)
+	{
+		uint8_t b;
+		SD_I2C_Result result = readByte(register_address, &b);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		*data = b & (1 << bitNum);
+		return result;
+	}
+
+	/**
+	 * @brief  Reads bitStart down to bitStart - length + 1 as a right-aligned value
+	 */
+	static SD_I2C_Result readBits(uint16_t register_address, uint8_t bitStart, uint8_t length, uint8_t* data)
+	{
+		uint8_t b;
+		SD_I2C_Result result = readByte(register_address, &b);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+		*data = (b & mask) >> (bitStart - length + 1);
+		return result;
+	}
+
+	/**
+	 * @brief  Read-modify-writes a single bit
+	 */
+	static SD_I2C_Result writeBit(uint16_t register_address, uint8_t bitNum, uint8_t data)
+	{
+		uint8_t b;
+		SD_I2C_Result result = readByte(register_address, &b);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
+		return writeByte(register_address, b);
+	}
+
+	/**
+	 * @brief  Read-modify-writes bitStart down to bitStart - length + 1 with a right-aligned value
+	 */
+	static SD_I2C_Result writeBits(uint16_t register_address, uint8_t bitStart, uint8_t length, uint8_t data)
+	{
+		uint8_t b;
+		SD_I2C_Result result = readByte(register_address, &b);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+		b = (b & ~mask) | ((data << (bitStart - length + 1)) & mask);
+		return writeByte(register_address, b);
+	}
+
+	/**
+	 * @brief  Reads a single bit of a 16-bit register, masked but not shifted
+	 */
+	static SD_I2C_Result readBitW(uint16_t register_address, uint8_t bitNum, uint16_t* data)
+	{
+		uint16_t w;
+		SD_I2C_Result result = readWord(register_address, &w);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		*data = w & (1 << bitNum);
+		return result;
+	}
+
+	/**
+	 * @brief  Reads bits of a 16-bit register as a right-aligned value
+	 */
+	static SD_I2C_Result readBitsW(uint16_t register_address, uint8_t bitStart, uint8_t length, uint16_t* data)
+	{
+		uint16_t w;
+		SD_I2C_Result result = readWord(register_address, &w);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		uint16_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+		*data = (w & mask) >> (bitStart - length + 1);
+		return result;
+	}
+
+	/**
+	 * @brief  Read-modify-writes a single bit of a 16-bit register
+	 */
+	static SD_I2C_Result writeBitW(uint16_t register_address, uint8_t bitNum, uint16_t data)
+	{
+		uint16_t w;
+		SD_I2C_Result result = readWord(register_address, &w);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		w = (data != 0) ? (w | (1 << bitNum)) : (w & ~(1 << bitNum));
+		return writeWord(register_address, w);
+	}
+
+	/**
+	 * @brief  Read-modify-writes bits of a 16-bit register with a right-aligned value
+	 */
+	static SD_I2C_Result writeBitsW(uint16_t register_address, uint8_t bitStart, uint8_t length, uint16_t data)
+	{
+		uint16_t w;
+		SD_I2C_Result result = readWord(register_address, &w);
+		if (result != SD_I2C_Result_Ok)
+			return result;
+		uint16_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+		w = (w & ~mask) | ((data << (bitStart - length + 1)) & mask);
+		return writeWord(register_address, w);
+	}
+};
+
+/**
+ * @}
+ */
+
+} /* namespace sd_i2c */
+
+#endif /* DRIVERS_MYLIB_SD_HAL_I2C_HPP_ */